@@ -8,7 +8,13 @@
 #include <iomanip>
 #include <algorithm>
 #include <chrono>
+#include <vector>
+#include <string_view>
+#include <functional>
+#include <queue>
 #include "array_h_assignment.hpp"
+#include "csv_h_reader.hpp"
+#include "intern_h_pool.hpp"
 
 
 using namespace std;
@@ -27,8 +33,25 @@ bool compareRecords(const Record& a, const Record& b, SortMode mode) {
     }
 }
 
+bool compareRecords(const PackedRecord& a, const PackedRecord& b, SortMode mode) {
+    switch (mode) {
+        case BY_DATE:
+            return a.date < b.date;
+        case BY_CATEGORY:
+            return a.category < b.category;   // groups by handle, not alphabetically
+        case BY_PRICE:
+            return a.price < b.price;
+        default:
+            return false;
+    }
+}
+
+// The sorts are written once over the element type. PackedRecord is
+// trivially copyable, so every move below compiles down to a plain copy.
+
 // Bubble Sort
-void bubbleSort(Record* arr, int size, SortMode mode) {
+template <typename T>
+static void bubbleSortImpl(T* arr, int size, SortMode mode) {
     for (int i = 0; i < size - 1; ++i) {
         for (int j = 0; j < size - i - 1; ++j) {
             if (!compareRecords(arr[j], arr[j + 1], mode)) {
@@ -39,20 +62,22 @@ void bubbleSort(Record* arr, int size, SortMode mode) {
 }
 
 // Insertion Sort
-void insertionSort(Record* arr, int size, SortMode mode) {
+template <typename T>
+static void insertionSortImpl(T* arr, int size, SortMode mode) {
     for (int i = 1; i < size; ++i) {
-        Record key = arr[i];
+        T key = move(arr[i]);
         int j = i - 1;
         while (j >= 0 && !compareRecords(arr[j], key, mode)) {
-            arr[j + 1] = arr[j];
+            arr[j + 1] = move(arr[j]);
             j--;
         }
-        arr[j + 1] = key;
+        arr[j + 1] = move(key);
     }
 }
 
 // Selection Sort
-void selectionSort(Record* arr, int size, SortMode mode) {
+template <typename T>
+static void selectionSortImpl(T* arr, int size, SortMode mode) {
     for (int i = 0; i < size - 1; ++i) {
         int minIdx = i;
         for (int j = i + 1; j < size; ++j) {
@@ -67,11 +92,12 @@ void selectionSort(Record* arr, int size, SortMode mode) {
 }
 
 // Merge Sort
-void merge(Record* arr, int left, int mid, int right, SortMode mode) {
+template <typename T>
+static void mergeImpl(T* arr, int left, int mid, int right, SortMode mode) {
     int n1 = mid - left + 1;
     int n2 = right - mid;
-    Record* L = new Record[n1];
-    Record* R = new Record[n2];
+    T* L = new T[n1];
+    T* R = new T[n2];
 
     for (int i = 0; i < n1; i++) L[i] = arr[left + i];
     for (int j = 0; j < n2; j++) R[j] = arr[mid + 1 + j];
@@ -89,13 +115,433 @@ void merge(Record* arr, int left, int mid, int right, SortMode mode) {
     delete[] R;
 }
 
-void mergeSort(Record* arr, int left, int right, SortMode mode) {
+template <typename T>
+static void mergeSortImpl(T* arr, int left, int right, SortMode mode) {
     if (left < right) {
         int mid = left + (right - left) / 2;
-        mergeSort(arr, left, mid, mode);
-        mergeSort(arr, mid + 1, right, mode);
-        merge(arr, left, mid, right, mode);
+        mergeSortImpl(arr, left, mid, mode);
+        mergeSortImpl(arr, mid + 1, right, mode);
+        mergeImpl(arr, left, mid, right, mode);
+    }
+}
+
+void bubbleSort(Record* arr, int size, SortMode mode) { bubbleSortImpl(arr, size, mode); }
+void insertionSort(Record* arr, int size, SortMode mode) { insertionSortImpl(arr, size, mode); }
+void selectionSort(Record* arr, int size, SortMode mode) { selectionSortImpl(arr, size, mode); }
+void mergeSort(Record* arr, int left, int right, SortMode mode) { mergeSortImpl(arr, left, right, mode); }
+
+void bubbleSort(PackedRecord* arr, int size, SortMode mode) { bubbleSortImpl(arr, size, mode); }
+void insertionSort(PackedRecord* arr, int size, SortMode mode) { insertionSortImpl(arr, size, mode); }
+void selectionSort(PackedRecord* arr, int size, SortMode mode) { selectionSortImpl(arr, size, mode); }
+void mergeSort(PackedRecord* arr, int left, int right, SortMode mode) { mergeSortImpl(arr, left, right, mode); }
+
+// Introsort (pattern-defeating quicksort)
+// In-place and unstable: median-of-3 (ninther above 128) pivots, insertion
+// sort below 24 elements, heapsort once too many unbalanced partitions show
+// up, and an early exit when a partition was already in order. Runs of keys
+// equal to the previous pivot are split off in one pass.
+template <typename T>
+static void insertionSortRange(T* arr, int lo, int hi, SortMode mode) {
+    for (int i = lo + 1; i < hi; ++i) {
+        if (!compareRecords(arr[i], arr[i - 1], mode)) continue;
+        T key = move(arr[i]);
+        int j = i;
+        do {
+            arr[j] = move(arr[j - 1]);
+            --j;
+        } while (j > lo && compareRecords(key, arr[j - 1], mode));
+        arr[j] = move(key);
+    }
+}
+
+// Like insertionSortRange, but gives up after moving 8 elements.
+template <typename T>
+static bool partialInsertionSort(T* arr, int lo, int hi, SortMode mode) {
+    int moved = 0;
+    for (int i = lo + 1; i < hi; ++i) {
+        if (!compareRecords(arr[i], arr[i - 1], mode)) continue;
+        T key = move(arr[i]);
+        int j = i;
+        do {
+            arr[j] = move(arr[j - 1]);
+            --j;
+        } while (j > lo && compareRecords(key, arr[j - 1], mode));
+        arr[j] = move(key);
+        moved += i - j;
+        if (moved > 8) return false;
+    }
+    return true;
+}
+
+template <typename T>
+static void siftDown(T* arr, int lo, int root, int size, SortMode mode) {
+    while (true) {
+        int child = 2 * root + 1;
+        if (child >= size) return;
+        if (child + 1 < size && compareRecords(arr[lo + child], arr[lo + child + 1], mode)) child++;
+        if (!compareRecords(arr[lo + root], arr[lo + child], mode)) return;
+        swap(arr[lo + root], arr[lo + child]);
+        root = child;
+    }
+}
+
+template <typename T>
+static void heapSortRange(T* arr, int lo, int hi, SortMode mode) {
+    int size = hi - lo;
+    for (int i = size / 2 - 1; i >= 0; --i) siftDown(arr, lo, i, size, mode);
+    for (int end = size - 1; end > 0; --end) {
+        swap(arr[lo], arr[lo + end]);
+        siftDown(arr, lo, 0, end, mode);
+    }
+}
+
+template <typename T>
+static void sort3(T* arr, int a, int b, int c, SortMode mode) {
+    if (compareRecords(arr[b], arr[a], mode)) swap(arr[a], arr[b]);
+    if (compareRecords(arr[c], arr[b], mode)) swap(arr[b], arr[c]);
+    if (compareRecords(arr[b], arr[a], mode)) swap(arr[a], arr[b]);
+}
+
+// Pivot stays at arr[lo] while partitioning (it also stops the scans), so
+// the comparisons never see a moved-from record. Elements equal to the
+// pivot go right. Returns the final pivot position.
+template <typename T>
+static int partitionRight(T* arr, int lo, int hi, SortMode mode, bool& alreadyPartitioned) {
+    const T& pivot = arr[lo];
+    int first = lo, last = hi;
+    while (compareRecords(arr[++first], pivot, mode));
+    if (first - 1 == lo) while (first < last && !compareRecords(arr[--last], pivot, mode));
+    else while (!compareRecords(arr[--last], pivot, mode));
+
+    alreadyPartitioned = first >= last;
+    while (first < last) {
+        swap(arr[first], arr[last]);
+        while (compareRecords(arr[++first], pivot, mode));
+        while (!compareRecords(arr[--last], pivot, mode));
+    }
+    int pivotPos = first - 1;
+    swap(arr[lo], arr[pivotPos]);
+    return pivotPos;
+}
+
+// Elements equal to the pivot go left; used when the pivot equals the
+// element just before the range, i.e. a run of duplicates.
+template <typename T>
+static int partitionLeft(T* arr, int lo, int hi, SortMode mode) {
+    const T& pivot = arr[lo];
+    int first = lo, last = hi;
+    while (compareRecords(pivot, arr[--last], mode));
+    if (last + 1 == hi) while (first < last && !compareRecords(pivot, arr[++first], mode));
+    else while (!compareRecords(pivot, arr[++first], mode));
+
+    while (first < last) {
+        swap(arr[first], arr[last]);
+        while (compareRecords(pivot, arr[--last], mode));
+        while (!compareRecords(pivot, arr[++first], mode));
+    }
+    swap(arr[lo], arr[last]);
+    return last;
+}
+
+template <typename T>
+static void introSortLoop(T* arr, int lo, int hi, SortMode mode, int badAllowed, bool leftmost) {
+    const int INSERTION_CUTOFF = 24;
+    while (true) {
+        int size = hi - lo;
+        if (size < INSERTION_CUTOFF) {
+            insertionSortRange(arr, lo, hi, mode);
+            return;
+        }
+
+        // Move the median of 3 (or ninther) to arr[lo]
+        int half = size / 2;
+        if (size > 128) {
+            sort3(arr, lo, lo + half, hi - 1, mode);
+            sort3(arr, lo + 1, lo + half - 1, hi - 2, mode);
+            sort3(arr, lo + 2, lo + half + 1, hi - 3, mode);
+            sort3(arr, lo + half - 1, lo + half, lo + half + 1, mode);
+            swap(arr[lo], arr[lo + half]);
+        } else {
+            sort3(arr, lo + half, lo, hi - 1, mode);
+        }
+
+        if (!leftmost && !compareRecords(arr[lo - 1], arr[lo], mode)) {
+            lo = partitionLeft(arr, lo, hi, mode) + 1;
+            continue;
+        }
+
+        bool alreadyPartitioned;
+        int pivot = partitionRight(arr, lo, hi, mode, alreadyPartitioned);
+        int leftSize = pivot - lo;
+        int rightSize = hi - (pivot + 1);
+
+        if (leftSize < size / 8 || rightSize < size / 8) {
+            if (--badAllowed == 0) {
+                heapSortRange(arr, lo, hi, mode);
+                return;
+            }
+            // Break up patterns that keep producing bad pivots
+            if (leftSize >= INSERTION_CUTOFF) {
+                swap(arr[lo], arr[lo + leftSize / 4]);
+                swap(arr[pivot - 1], arr[pivot - leftSize / 4]);
+            }
+            if (rightSize >= INSERTION_CUTOFF) {
+                swap(arr[pivot + 1], arr[pivot + 1 + rightSize / 4]);
+                swap(arr[hi - 1], arr[hi - rightSize / 4]);
+            }
+        } else if (alreadyPartitioned &&
+                   partialInsertionSort(arr, lo, pivot, mode) &&
+                   partialInsertionSort(arr, pivot + 1, hi, mode)) {
+            return;
+        }
+
+        introSortLoop(arr, lo, pivot, mode, badAllowed, leftmost);
+        lo = pivot + 1;
+        leftmost = false;
+    }
+}
+
+template <typename T>
+static void introSortImpl(T* arr, int size, SortMode mode) {
+    if (size < 2) return;
+    int log2n = 0;
+    for (int n = size; n > 1; n >>= 1) log2n++;
+    introSortLoop(arr, 0, size, mode, log2n, true);
+}
+
+// TimSort
+// Stable. Detects existing ascending runs (and reverses strictly descending
+// ones), extends short runs to minRun with binary insertion, and merges
+// runs off a stack. Each merge first trims the parts that are already in
+// place, so concatenated sorted exports cost little more than one pass.
+// Scratch space is the smaller of the two runs being merged.
+template <typename T>
+static int upperBoundIn(const T* arr, int lo, int hi, const T& key, SortMode mode) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compareRecords(key, arr[mid], mode)) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+template <typename T>
+static int lowerBoundIn(const T* arr, int lo, int hi, const T& key, SortMode mode) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compareRecords(arr[mid], key, mode)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+template <typename T>
+static void binaryInsertionSort(T* arr, int lo, int hi, int start, SortMode mode) {
+    for (int i = start; i < hi; ++i) {
+        int pos = upperBoundIn(arr, lo, i, arr[i], mode);
+        if (pos == i) continue;
+        T key = move(arr[i]);
+        for (int j = i; j > pos; --j) arr[j] = move(arr[j - 1]);
+        arr[pos] = move(key);
+    }
+}
+
+template <typename T>
+static int countRunAndMakeAscending(T* arr, int lo, int hi, SortMode mode) {
+    int runHi = lo + 1;
+    if (runHi == hi) return 1;
+    if (compareRecords(arr[runHi++], arr[lo], mode)) {
+        while (runHi < hi && compareRecords(arr[runHi], arr[runHi - 1], mode)) runHi++;
+        reverse(arr + lo, arr + runHi);     // strictly descending, so reversing is stable
+    } else {
+        while (runHi < hi && !compareRecords(arr[runHi], arr[runHi - 1], mode)) runHi++;
+    }
+    return runHi - lo;
+}
+
+template <typename T>
+static void mergeRuns(T* arr, int base1, int len1, int base2, int len2, SortMode mode, vector<T>& tmp) {
+    // Skip the prefix of run 1 that is already in place...
+    int skip = upperBoundIn(arr, base1, base1 + len1, arr[base2], mode) - base1;
+    base1 += skip;
+    len1 -= skip;
+    if (len1 == 0) return;
+    // ...and the suffix of run 2 that is already in place.
+    len2 = lowerBoundIn(arr, base2, base2 + len2, arr[base1 + len1 - 1], mode) - base2;
+    if (len2 == 0) return;
+
+    if (len1 <= len2) {
+        // Copy run 1 out and merge forward
+        tmp.assign(make_move_iterator(arr + base1), make_move_iterator(arr + base1 + len1));
+        int i = 0, j = base2, k = base1, end2 = base2 + len2;
+        while (i < len1 && j < end2) {
+            if (compareRecords(arr[j], tmp[i], mode)) arr[k++] = move(arr[j++]);
+            else arr[k++] = move(tmp[i++]);
+        }
+        while (i < len1) arr[k++] = move(tmp[i++]);
+    } else {
+        // Copy run 2 out and merge backward
+        tmp.assign(make_move_iterator(arr + base2), make_move_iterator(arr + base2 + len2));
+        int i = base1 + len1 - 1, j = len2 - 1, k = base2 + len2 - 1;
+        while (i >= base1 && j >= 0) {
+            if (compareRecords(tmp[j], arr[i], mode)) arr[k--] = move(arr[i--]);
+            else arr[k--] = move(tmp[j--]);
+        }
+        while (j >= 0) arr[k--] = move(tmp[j--]);
+    }
+}
+
+template <typename T>
+static void timSortImpl(T* arr, int size, SortMode mode) {
+    if (size < 2) return;
+
+    int minRun;
+    {
+        int n = size, r = 0;
+        while (n >= 64) {
+            r |= n & 1;
+            n >>= 1;
+        }
+        minRun = n + r;
+    }
+
+    vector<pair<int, int>> runs;    // (base, length)
+    vector<T> tmp;
+
+    auto mergeAt = [&](int i) {
+        mergeRuns(arr, runs[i].first, runs[i].second, runs[i + 1].first, runs[i + 1].second, mode, tmp);
+        runs[i].second += runs[i + 1].second;
+        runs.erase(runs.begin() + i + 1);
+    };
+
+    int lo = 0;
+    while (lo < size) {
+        int runLen = countRunAndMakeAscending(arr, lo, size, mode);
+        if (runLen < minRun) {
+            int forced = min(minRun, size - lo);
+            binaryInsertionSort(arr, lo, lo + forced, lo + runLen, mode);
+            runLen = forced;
+        }
+        runs.push_back({lo, runLen});
+        lo += runLen;
+
+        // Keep run lengths decreasing like Fibonacci numbers down the stack
+        while (runs.size() > 1) {
+            int n = runs.size() - 2;
+            if ((n > 0 && runs[n - 1].second <= runs[n].second + runs[n + 1].second) ||
+                (n > 1 && runs[n - 2].second <= runs[n - 1].second + runs[n].second)) {
+                if (runs[n - 1].second < runs[n + 1].second) n--;
+                mergeAt(n);
+            } else if (runs[n].second <= runs[n + 1].second) {
+                mergeAt(n);
+            } else {
+                break;
+            }
+        }
+    }
+    while (runs.size() > 1) {
+        int n = runs.size() - 2;
+        if (n > 0 && runs[n - 1].second < runs[n + 1].second) n--;
+        mergeAt(n);
+    }
+}
+
+void introSort(Record* arr, int size, SortMode mode) { introSortImpl(arr, size, mode); }
+void timSort(Record* arr, int size, SortMode mode) { timSortImpl(arr, size, mode); }
+void introSort(PackedRecord* arr, int size, SortMode mode) { introSortImpl(arr, size, mode); }
+void timSort(PackedRecord* arr, int size, SortMode mode) { timSortImpl(arr, size, mode); }
+
+// Packed copies of a Record array (and back)
+PackedRecord* packRecords(const Record* arr, int size) {
+    PackedRecord* packed = new PackedRecord[size > 0 ? size : 1];
+    for (int i = 0; i < size; ++i) packed[i] = packRecord(arr[i]);
+    return packed;
+}
+
+Record* unpackRecords(const PackedRecord* arr, int size) {
+    Record* records = new Record[size > 0 ? size : 1];
+    for (int i = 0; i < size; ++i) records[i] = unpackRecord<Record>(arr[i]);
+    return records;
+}
+
+
+// Top-K Selection
+// Bounded min-heap of the k largest records seen so far: O(n log k) instead
+// of a full sort. Results come back largest first (most expensive / most
+// recent), as a new[] array of min(k, size) records.
+struct TopKHeapOrder {
+    SortMode mode;
+    bool operator()(const Record* a, const Record* b) const {
+        return compareRecords(*b, *a, mode);    // smallest on top
+    }
+};
+
+static void collectTopK(const Record* begin, const Record* end, int k, SortMode mode,
+                        vector<const Record*>& out) {
+    priority_queue<const Record*, vector<const Record*>, TopKHeapOrder> heap(TopKHeapOrder{mode});
+    for (const Record* r = begin; r != end; ++r) {
+        if ((int)heap.size() < k) heap.push(r);
+        else if (compareRecords(*heap.top(), *r, mode)) {
+            heap.pop();
+            heap.push(r);
+        }
+    }
+    out.clear();
+    while (!heap.empty()) {
+        out.push_back(heap.top());
+        heap.pop();
+    }
+    reverse(out.begin(), out.end());
+}
+
+Record* topK(Record* arr, int size, int k, SortMode mode) {
+    if (k > size) k = size;
+    if (k <= 0 || arr == nullptr) return nullptr;
+
+    vector<const Record*> best;
+    collectTopK(arr, arr + size, k, mode, best);
+
+    Record* result = new Record[k];
+    for (int i = 0; i < k; ++i) result[i] = *best[i];
+    return result;
+}
+
+// Each thread keeps its own heap over a slice; the per-thread winners are
+// then merged with one more bounded heap.
+Record* topKParallel(Record* arr, int size, int k, SortMode mode, int threads) {
+    if (k > size) k = size;
+    if (k <= 0 || arr == nullptr) return nullptr;
+    if (threads < 1) threads = 1;
+    if (threads > size / 1024 + 1) threads = size / 1024 + 1;
+
+    vector<vector<const Record*>> partial(threads);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            long long from = (long long)size * t / threads;
+            long long to = (long long)size * (t + 1) / threads;
+            collectTopK(arr + from, arr + to, k, mode, partial[t]);
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    vector<const Record*> candidates;
+    for (const auto& p : partial) candidates.insert(candidates.end(), p.begin(), p.end());
+    priority_queue<const Record*, vector<const Record*>, TopKHeapOrder> heap(TopKHeapOrder{mode});
+    for (const Record* r : candidates) {
+        if ((int)heap.size() < k) heap.push(r);
+        else if (compareRecords(*heap.top(), *r, mode)) {
+            heap.pop();
+            heap.push(r);
+        }
+    }
+
+    Record* result = new Record[k];
+    for (int i = k - 1; i >= 0; --i) {
+        result[i] = *heap.top();
+        heap.pop();
     }
+    return result;
 }
 
 
@@ -109,8 +555,21 @@ int linearSearch(Record* arr, int size, const string& targetDate) {
     return -1;  // No match found
 }
 
-int binarySearch(Record* arr, int size, const string& target, SortMode mode) {
+// Same, over the date column: 64 rows per bitmap word via the SIMD kernel
+int linearSearch(const TransactionColumns& columns, const string& targetDate) {
+    int n = columns.size();
+    vector<uint64_t> bitmap(bitmapWords(n));
+    int target = dateKey(targetDate);
+    if (scanDateEquals(columns.date.data(), n, target, bitmap.data()) == 0) return -1;
+    return nextSelected(bitmap.data(), n, 0);
+}
+
+// The searches are written over anything indexable: a Record* or a
+// RecordView that reads the array through a sort permutation.
+template <typename Seq>
+static int binarySearchImpl(const Seq& arr, int size, const string& target, SortMode mode) {
     int left = 0, right = size - 1;
+    int targetKey = (mode == BY_CATEGORY) ? globalStringPool().find(target) : -1;
 
     while (left <= right) {
         int mid = left + (right - left) / 2;
@@ -118,14 +577,14 @@ int binarySearch(Record* arr, int size, const string& target, SortMode mode) {
         switch (mode) {
             case BY_DATE: {
                 int midVal = arr[mid].dateToInt();
-                int targetVal = Record{.date = target}.dateToInt();
+                int targetVal = dateKey(target);
                 if (midVal == targetVal) return mid;
                 else if (midVal < targetVal) left = mid + 1;
                 else right = mid - 1;
                 break;
             }
             case BY_CATEGORY: {
-                if (arr[mid].category == target) return mid;
+                if (arr[mid].category.handle() == targetKey) return mid;
                 else if (arr[mid].category < target) left = mid + 1;
                 else right = mid - 1;
                 break;
@@ -139,12 +598,13 @@ int binarySearch(Record* arr, int size, const string& target, SortMode mode) {
 }
 
 
-int interpolationSearch(Record* arr, int size, const string& targetDate) {
+template <typename Seq>
+static int interpolationSearchImpl(const Seq& arr, int size, const string& targetDate) {
     int lo = 0, hi = size - 1;
-    int targetInt = Record{.date = targetDate}.dateToInt();
+    int targetInt = dateKey(targetDate);
 
     while (lo <= hi && targetInt >= arr[lo].dateToInt() && targetInt <= arr[hi].dateToInt()) {
-        if (lo == hi) {
+        if (lo == hi || arr[hi].dateToInt() == arr[lo].dateToInt()) {
             if (arr[lo].dateToInt() == targetInt) return lo;
             return -1;
         }
@@ -158,8 +618,9 @@ int interpolationSearch(Record* arr, int size, const string& targetDate) {
     return -1;
 }
 
-int jumpSearch(Record* arr, int size, const string& targetDate) {
-    int targetInt = Record{.date = targetDate}.dateToInt();
+template <typename Seq>
+static int jumpSearchImpl(const Seq& arr, int size, const string& targetDate) {
+    int targetInt = dateKey(targetDate);
     int step = sqrt(size);
     int prev = 0;
 
@@ -176,41 +637,86 @@ int jumpSearch(Record* arr, int size, const string& targetDate) {
     return -1;
 }
 
+int binarySearch(Record* arr, int size, const string& target, SortMode mode) {
+    return binarySearchImpl(arr, size, target, mode);
+}
+
+int interpolationSearch(Record* arr, int size, const string& targetDate) {
+    return interpolationSearchImpl(arr, size, targetDate);
+}
+
+int jumpSearch(Record* arr, int size, const string& targetDate) {
+    return jumpSearchImpl(arr, size, targetDate);
+}
+
+// Searches through a permutation; results are positions in the view.
+int binarySearch(const RecordView& view, const string& target, SortMode mode) {
+    return binarySearchImpl(view, view.size, target, mode);
+}
+
+int interpolationSearch(const RecordView& view, const string& targetDate) {
+    return interpolationSearchImpl(view, view.size, targetDate);
+}
+
+int jumpSearch(const RecordView& view, const string& targetDate) {
+    return jumpSearchImpl(view, view.size, targetDate);
+}
+
+// Argsort
+// Returns the stable ordering of arr under mode without moving any record.
+// Keys are extracted once, so the sort compares ints/doubles, not strings
+// re-parsed on every comparison.
+vector<int32_t> argsort(const Record* arr, int size, SortMode mode) {
+    vector<int32_t> order(size);
+    for (int i = 0; i < size; ++i) order[i] = i;
+
+    switch (mode) {
+        case BY_DATE: {
+            vector<int> keys(size);
+            for (int i = 0; i < size; ++i) keys[i] = arr[i].dateToInt();
+            stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b) { return keys[a] < keys[b]; });
+            break;
+        }
+        case BY_PRICE: {
+            stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b) { return arr[a].price < arr[b].price; });
+            break;
+        }
+        case BY_CATEGORY: {
+            order = argsortByText(arr, size, &Record::category);
+            break;
+        }
+    }
+    return order;
+}
+
+// Stable ordering on any string field (product, customerID, ...) via the
+// multikey string sort in string_h_sort.hpp.
+vector<int32_t> argsortByText(const Record* arr, int size, InternedString Record::*field) {
+    return stringSortOrder(size, [&](int i) { return string_view(arr[i].*field); });
+}
+
 // Utility Functions
-void processElectronicsCreditCardPercentage(Record* transactions, int size) {
-    if (size == 0 || transactions == nullptr) {
+void processElectronicsCreditCardPercentage(const TransactionCube& cube) {
+    if (cube.cellCount() == 0) {
         cout << "No transactions found." << endl;
         return;
     }
 
-    // Step 1: Sort by category
-    mergeSort(transactions, 0, size - 1, BY_CATEGORY);
+    // Step 1: The cube was filled once by the loader (no sort, no rescan)
     cout << "\n=== ELECTRONICS CATEGORY PAYMENT ANALYSIS ===\n";
 
-    // Step 2: Binary search using SortMode
-    int index = binarySearch(transactions, size, "Electronics", BY_CATEGORY);
-    if (index == -1) {
+    // Step 2: Read the two cells
+    StringPool& pool = globalStringPool();
+    int electronicsKey = pool.find("Electronics");
+    int creditCardKey = pool.find("Credit Card");
+    int totalElectronics = electronicsKey < 0 ? 0 : cube.cell(electronicsKey, TransactionCube::ANY).count;
+    if (totalElectronics == 0) {
         cout << "No transactions in Electronics category.\n";
         return;
     }
+    int creditCardElectronics = creditCardKey < 0 ? 0 : cube.cell(electronicsKey, creditCardKey).count;
 
-    // Step 3: Expand left/right to gather all matching entries
-    int left = index - 1;
-    while (left >= 0 && transactions[left].category == "Electronics") left--;
-    int right = index + 1;
-    while (right < size && transactions[right].category == "Electronics") right++;
-
-    // Step 4: Count total + credit card payments
-    int totalElectronics = 0;
-    int creditCardElectronics = 0;
-    for (int i = left + 1; i < right; ++i) {
-        totalElectronics++;
-        if (transactions[i].paymentMethod == "Credit Card") {
-            creditCardElectronics++;
-        }
-    }
-
-    // Step 5: Output
+    // Step 3: Output
     double percentage = (totalElectronics > 0)
         ? (static_cast<double>(creditCardElectronics) / totalElectronics) * 100.0
         : 0.0;
@@ -231,79 +737,205 @@ string cleanWord(const string& word) {
     return cleaned;
 }
 
+// Text fields are interned as they are parsed (the pool is thread-safe)
+bool parseTransactionRow(string_view line, Record& record) {
+    string fields[6];
+    if (parseCSVRecord(line, fields, 6) < 6) return false;
+    record.customerID = fields[0];
+    record.product = fields[1];
+    record.category = fields[2];
+    record.price = parseDouble(fields[3]);
+    record.date = fields[4];
+    record.paymentMethod = fields[5];
+    return true;
+}
+
+bool parseReviewRow(string_view line, Review& review) {
+    string fields[4];
+    if (parseCSVRecord(line, fields, 4) < 4) return false;
+    review.product_id = fields[0];
+    review.customer_id = fields[1];
+    review.rating = parseInt(fields[2]);
+    review.review = move(fields[3]);
+    return true;
+}
+
 int readTransactionCSV(const string& filename, Record*& arr) {
-    ifstream file(filename);
-    string line;
+    if (isColumnarFile(filename)) return readTransactionColumnar(filename, arr);
+
+    AsyncLineReader reader(filename);
+    string_view line;
     int count = 0;
     int capacity = 100;
     arr = new Record[capacity];
 
-    if (!file.is_open()) {
+    if (!reader.is_open()) {
         cerr << "Error: Could not open transaction file." << endl;
         return 0;
     }
 
-    getline(file, line);
+    reader.nextRecord(line); // Skip header
 
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string customerID, product, category, priceStr, date, paymentMethod;
-        getline(ss, customerID, ',');
-        getline(ss, product, ',');
-        getline(ss, category, ',');
-        getline(ss, priceStr, ',');
-        getline(ss, date, ',');
-        getline(ss, paymentMethod, ',');
+    Record record;
+    while (reader.nextRecord(line)) {
+        if (!parseTransactionRow(line, record)) continue;
 
         if (count == capacity) {
             capacity *= 2;
             Record* newArr = new Record[capacity];
-            for (int i = 0; i < count; ++i) newArr[i] = arr[i];
+            for (int i = 0; i < count; ++i) newArr[i] = move(arr[i]);
             delete[] arr;
             arr = newArr;
         }
 
-        arr[count++] = {customerID, product, category, stod(priceStr), date, paymentMethod};
+        arr[count++] = move(record);
     }
 
-    file.close();
     return count;
 }
 
 int readReviewCSV(const string& filename, Review*& arr) {
-    ifstream file(filename);
-    string line;
+    if (isColumnarFile(filename)) return readReviewColumnar(filename, arr);
+
+    AsyncLineReader reader(filename);
+    string_view line;
     int count = 0;
     int capacity = 100;
     arr = new Review[capacity];
 
-    if (!file.is_open()) {
+    if (!reader.is_open()) {
         cerr << "Error: Could not open review file." << endl;
         return 0;
     }
 
-    getline(file, line);
+    reader.nextRecord(line); // Skip header
 
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string product_id, customer_id, ratingStr, review;
-        getline(ss, product_id, ',');
-        getline(ss, customer_id, ',');
-        getline(ss, ratingStr, ',');
-        getline(ss, review); 
+    Review review;
+    while (reader.nextRecord(line)) {
+        if (!parseReviewRow(line, review)) continue;
 
         if (count == capacity) {
             capacity *= 2;
             Review* newArr = new Review[capacity];
-            for (int i = 0; i < count; ++i) newArr[i] = arr[i];
+            for (int i = 0; i < count; ++i) newArr[i] = move(arr[i]);
             delete[] arr;
             arr = newArr;
         }
 
-        arr[count++] = {product_id, customer_id, stoi(ratingStr), review};
+        arr[count++] = move(review);
     }
 
-    file.close();
+    return count;
+}
+
+// Parallel loaders: chunks are parsed concurrently, then copied into one
+// array in file order.
+// If `stats` is given, each parsed chunk is sketched on its own thread and
+// the chunk sketches are merged into it.
+int readTransactionCSVParallel(const string& filename, Record*& arr, int threads, TransactionStats* stats,
+                               TransactionCube* cube) {
+    if (isColumnarFile(filename)) {
+        int count = readTransactionColumnar(filename, arr);
+        if (stats)
+            for (int i = 0; i < count; ++i) stats->add(arr[i]);
+        if (cube) cube->build(arr, count);
+        return count;
+    }
+
+    vector<vector<Record>> chunks;
+    arr = nullptr;
+    if (!parallelParseCSV<Record>(filename, threads, parseTransactionRow, chunks)) {
+        cerr << "Error: Could not open transaction file." << endl;
+        return 0;
+    }
+
+    if (stats) {
+        vector<TransactionStats> partial(chunks.size(), stats->emptyCopy());
+        vector<thread> workers;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] {
+                for (const auto& record : chunks[i]) partial[i].add(record);
+            });
+        }
+        for (auto& w : workers) w.join();
+        for (const auto& p : partial) stats->merge(p);
+    }
+
+    if (cube) {
+        vector<TransactionCube> partial(chunks.size());
+        vector<thread> workers;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] { partial[i].build(chunks[i].data(), (int)chunks[i].size()); });
+        }
+        for (auto& w : workers) w.join();
+        for (const auto& p : partial) cube->merge(p);
+    }
+
+    int count = 0;
+    for (const auto& chunk : chunks) count += chunk.size();
+    arr = new Record[count > 0 ? count : 1];
+
+    int k = 0;
+    for (auto& chunk : chunks)
+        for (auto& record : chunk) arr[k++] = move(record);
+    return count;
+}
+
+int readReviewCSVParallel(const string& filename, Review*& arr, int threads) {
+    if (isColumnarFile(filename)) return readReviewColumnar(filename, arr);
+
+    vector<vector<Review>> chunks;
+    arr = nullptr;
+    if (!parallelParseCSV<Review>(filename, threads, parseReviewRow, chunks)) {
+        cerr << "Error: Could not open review file." << endl;
+        return 0;
+    }
+
+    int count = 0;
+    for (const auto& chunk : chunks) count += chunk.size();
+    arr = new Review[count > 0 ? count : 1];
+
+    int k = 0;
+    for (auto& chunk : chunks)
+        for (auto& review : chunk) arr[k++] = move(review);
+    return count;
+}
+
+// Columnar Storage
+bool saveTransactionsColumnar(const string& filename, const Record* arr, int size) {
+    return writeTransactionsColumnar(filename, size, [&](int i) -> const Record& { return arr[i]; });
+}
+
+bool saveReviewsColumnar(const string& filename, const Review* arr, int size) {
+    return writeReviewsColumnar(filename, size, [&](int i) -> const Review& { return arr[i]; });
+}
+
+int readTransactionColumnar(const string& filename, Record*& arr, const TransactionPredicate& pred,
+                            ColumnarScanInfo* scan) {
+    vector<Record> rows;
+    arr = nullptr;
+    if (!readTransactionsColumnar(filename, rows, pred, scan)) {
+        cerr << "Error: Could not read columnar transaction file." << endl;
+        return 0;
+    }
+
+    int count = rows.size();
+    arr = new Record[count > 0 ? count : 1];
+    for (int i = 0; i < count; ++i) arr[i] = move(rows[i]);
+    return count;
+}
+
+int readReviewColumnar(const string& filename, Review*& arr, const ReviewPredicate& pred, ColumnarScanInfo* scan) {
+    vector<Review> rows;
+    arr = nullptr;
+    if (!readReviewsColumnar(filename, rows, pred, scan)) {
+        cerr << "Error: Could not read columnar review file." << endl;
+        return 0;
+    }
+
+    int count = rows.size();
+    arr = new Review[count > 0 ? count : 1];
+    for (int i = 0; i < count; ++i) arr[i] = move(rows[i]);
     return count;
 }
 
@@ -343,32 +975,70 @@ void mergeSortR(Review* arr, int left, int right) {
     }
 }
 
+// Counting sort: one pass over the keys, one scatter into a new array
+static void scatterReviews(Review*& arr, int count, const vector<int32_t>& slots) {
+    Review* sorted = new Review[count > 0 ? count : 1];
+    for (int i = 0; i < count; ++i) sorted[slots[i]] = move(arr[i]);
+    delete[] arr;
+    arr = sorted;
+}
+
+void countingSortReviews(Review*& arr, int count, ReviewSortKey key, bool descending) {
+    auto slots = countingSortSlots(count, [&](int i) { return reviewSortKey(arr[i], key); }, descending, false);
+    scatterReviews(arr, count, slots);
+}
+
+// Same order as the linked backend's mergeSortByReviewLength
+void countingSortByReviewLength(Review*& arr, int count) {
+    auto slots = countingSortSlots(count, [&](int i) { return (int)arr[i].review.length(); }, true, true);
+    scatterReviews(arr, count, slots);
+}
+
+// Drop-in for mergeSortR with the same resulting order (equal texts end up
+// in reverse input order, as mergeR takes the right side on ties). Sorts
+// indices on cached 8-byte prefixes, then moves each review once.
+void multikeySortR(Review* arr, int left, int right) {
+    int count = right - left + 1;
+    if (count < 2) return;
+    Review* base = arr + left;
+    vector<int32_t> order = stringSortOrder(count, [&](int i) { return string_view(base[i].review); }, true);
+
+    vector<Review> sorted;
+    sorted.reserve(count);
+    for (int32_t i : order) sorted.push_back(move(base[i]));
+    for (int i = 0; i < count; ++i) base[i] = move(sorted[i]);
+}
+
 
 void displayTransactions(Record* arr, int size) {
+    OutputWriter out;
     for (int i = 0; i < size; ++i) {
-        cout << arr[i].customerID << ",";
-        cout << arr[i].product << ",";
-        cout << arr[i].category << ",";
-        cout << arr[i].price <<  ",";
-        cout << arr[i].date <<  ",";
-        cout << arr[i].paymentMethod << "\n";
+        out << arr[i].customerID << ',';
+        out << arr[i].product << ',';
+        out << arr[i].category << ',';
+        out << arr[i].price << ',';
+        out << arr[i].date << ',';
+        out << arr[i].paymentMethod << '\n';
     }
 }
 
 int filterReviews(Review*& reviews, int reviewCount, Record* transactions, int transCount) {
-    unordered_map<string, int> transactionCounts;
+    // Per-customer counters indexed by interned customer handle
+    StringPool& pool = globalStringPool();
+
+    vector<int> transactionCounts(pool.size(), 0);
     for (int i = 0; i < transCount; ++i) {
-        transactionCounts[transactions[i].customerID]++;
+        transactionCounts[transactions[i].customerID.handle()]++;
     }
 
-    unordered_map<string, int> reviewCounts;
+    vector<int> reviewCounts(pool.size(), 0);
     Review* filtered = new Review[reviewCount];
     int validCount = 0;
 
     for (int i = 0; i < reviewCount; ++i) {
-        string cid = reviews[i].customer_id;
+        int cid = reviews[i].customer_id.handle();
         if (reviewCounts[cid] < transactionCounts[cid]) {
-            filtered[validCount++] = reviews[i];
+            filtered[validCount++] = move(reviews[i]);
             reviewCounts[cid]++;
         }
     }
@@ -378,11 +1048,11 @@ int filterReviews(Review*& reviews, int reviewCount, Record* transactions, int t
     return validCount;
 }
 
-void analyzeOneStarReviews(Review* reviews, int count) {
+unordered_map<string, int> countWordFrequencies(const Review* reviews, int count, int rating) {
     unordered_map<string, int> wordFreq;
 
     for (int i = 0; i < count; ++i) {
-        if (reviews[i].rating == 1) {
+        if (reviews[i].rating == rating) {
             stringstream ss(reviews[i].review);
             string word;
             while (ss >> word) {
@@ -391,6 +1061,51 @@ void analyzeOneStarReviews(Review* reviews, int count) {
             }
         }
     }
+    return wordFreq;
+}
+
+// Per-category sketch summary; counts are estimates (see stats_h_sketches.hpp)
+void displayTransactionStats(const TransactionStats& stats) {
+    cout << "\n=== CATEGORY STATISTICS (approximate) ===\n";
+    for (const string& category : stats.categoryNames()) {
+        cout << category << ": " << stats.transactionCount(category) << " transactions, ~"
+             << fixed << setprecision(0) << stats.distinctCustomers(category) << " customers, price p50 $"
+             << setprecision(2) << stats.priceQuantile(category, 0.50)
+             << ", p95 $" << stats.priceQuantile(category, 0.95)
+             << ", p99 $" << stats.priceQuantile(category, 0.99) << "\n";
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+}
+
+// Top phrases for every rating bucket, 5 stars down to 1
+void analyzeReviewNGrams(const Review* reviews, int count, const NGramOptions& options, int limit) {
+    NGramAnalyzer analyzer(options);
+    for (int i = 0; i < count; ++i) {
+        analyzer.addReview(reviews[i].review, reviews[i].rating);
+    }
+
+    for (int rating = NGramAnalyzer::RATINGS; rating >= 1; --rating) {
+        vector<NGramCount> top = analyzer.top(rating, limit);
+        cout << "\nTop " << options.n << "-grams in " << rating << "-star reviews"
+             << (options.exact ? "" : " (approximate)") << ":\n";
+        if (top.empty()) cout << "None found.\n";
+        for (const auto& entry : top) {
+            cout << entry.ngram << ": " << entry.count << endl;
+        }
+    }
+}
+
+// Review IDs are array indices, so appending reviews and calling this again
+// extends the index without rebuilding it
+void buildReviewTextIndex(const Review* reviews, int count, ReviewTextIndex& index) {
+    for (int i = index.reviewCount(); i < count; ++i) {
+        index.addReview(reviews[i].review, reviews[i].rating, reviews[i].product_id);
+    }
+}
+
+void analyzeOneStarReviews(Review* reviews, int count) {
+    unordered_map<string, int> wordFreq = countWordFrequencies(reviews, count, 1);
 
     if (wordFreq.empty()) {
         cout << "No 1-star reviews found.\n";
@@ -402,12 +1117,577 @@ void analyzeOneStarReviews(Review* reviews, int count) {
         sortedWords.insert({pair.second, pair.first});
     }
 
-    cout << "\nWord Frequencies in 1-Star Reviews:\n";
+    OutputWriter out;
+    out << "\nWord Frequencies in 1-Star Reviews:\n";
     for (const auto& [freq, word] : sortedWords) {
-        cout << word << ": " << freq << endl;
+        out << word << ": " << freq << '\n';
+    }
+}
+
+
+// Bitmap Indexes
+void buildTransactionBitmaps(Record* transactions, int size, TransactionBitmaps& index) {
+    index = TransactionBitmaps();
+    for (int i = 0; i < size; ++i) {
+        index.category.add(transactions[i].category.handle(), i);
+        index.payment.add(transactions[i].paymentMethod.handle(), i);
+    }
+    index.rows = size;
+}
+
+void buildReviewBitmaps(Review* reviews, int reviewCount, Record* transactions, int transCount, ReviewBitmaps& index) {
+    StringPool& pool = globalStringPool();
+
+    vector<char> buyer(pool.size(), 0);
+    for (int i = 0; i < transCount; ++i) buyer[transactions[i].customerID.handle()] = 1;
+
+    index = ReviewBitmaps();
+    for (int i = 0; i < reviewCount; ++i) {
+        index.rating.add(reviews[i].rating, i);
+        if (buyer[reviews[i].customer_id.handle()]) index.hasTransaction.add(i);
     }
+    index.rows = reviewCount;
 }
 
+void processElectronicsCreditCardPercentage(const TransactionBitmaps& index) {
+    if (index.rows == 0) {
+        cout << "No transactions found." << endl;
+        return;
+    }
+    cout << "\n=== ELECTRONICS CATEGORY PAYMENT ANALYSIS ===\n";
+
+    // Both counts are popcounts; the AND never materialises a row list
+    StringPool& pool = globalStringPool();
+    int electronicsKey = pool.find("Electronics");
+    int creditCardKey = pool.find("Credit Card");
+    const RoaringBitmap& electronics = index.category.rowsWith(electronicsKey);
+    int totalElectronics = (int)electronics.cardinality();
+    if (totalElectronics == 0) {
+        cout << "No transactions in Electronics category.\n";
+        return;
+    }
+    int creditCardElectronics =
+        (int)RoaringBitmap::andCardinality(electronics, index.payment.rowsWith(creditCardKey));
+
+    double percentage = (static_cast<double>(creditCardElectronics) / totalElectronics) * 100.0;
+
+    cout << "Total Electronics Transactions: " << totalElectronics << endl;
+    cout << "Electronics transactions paid via Credit Card: " << creditCardElectronics << endl;
+    cout << "Percentage of Electronics purchases made using Credit Card: "
+         << fixed << setprecision(2) << percentage << "%\n";
+}
+
+// Copies the selected rows (in row order) into a new[] array
+int selectReviews(const Review* reviews, const RoaringBitmap& rows, Review*& out) {
+    int count = (int)rows.cardinality();
+    out = new Review[count > 0 ? count : 1];
+    int n = 0;
+    rows.forEach([&](uint32_t row) { out[n++] = reviews[row]; });
+    return n;
+}
+
+// Customer Join
+static void customerKeyColumns(Review* reviews, int reviewCount, Record* transactions, int transCount,
+                               vector<int32_t>& reviewKeys, vector<int32_t>& transactionKeys) {
+    reviewKeys.resize(reviewCount);
+    transactionKeys.resize(transCount);
+    for (int i = 0; i < reviewCount; ++i) reviewKeys[i] = reviews[i].customer_id.handle();
+    for (int i = 0; i < transCount; ++i) transactionKeys[i] = transactions[i].customerID.handle();
+}
+
+vector<JoinPair> joinReviewsToTransactions(Review* reviews, int reviewCount, Record* transactions, int transCount,
+                                           int threads) {
+    vector<int32_t> reviewKeys, transactionKeys;
+    customerKeyColumns(reviews, reviewCount, transactions, transCount, reviewKeys, transactionKeys);
+    if (threads <= 1)
+        return hashJoinPairs(transactionKeys.data(), transCount, reviewKeys.data(), reviewCount);
+
+    vector<JoinPair> pairs = radixHashJoin(transactionKeys.data(), transCount, reviewKeys.data(), reviewCount, threads);
+    sort(pairs.begin(), pairs.end(), [](const JoinPair& a, const JoinPair& b) {
+        return a.probeRow != b.probeRow ? a.probeRow < b.probeRow : a.buildRow < b.buildRow;
+    });
+    return pairs;
+}
+
+void forEachReviewTransaction(Review* reviews, int reviewCount, Record* transactions, int transCount,
+                              const function<void(const Review&, const Record&)>& fn) {
+    vector<int32_t> reviewKeys, transactionKeys;
+    customerKeyColumns(reviews, reviewCount, transactions, transCount, reviewKeys, transactionKeys);
+    hashJoin(transactionKeys.data(), transCount, reviewKeys.data(), reviewCount,
+             [&](int r, int t) { fn(reviews[r], transactions[t]); });
+}
+
+// Concurrent Store
+ConcurrentTransactionStore::ConcurrentTransactionStore() : current(new TransactionSnapshot()), epoch(1) {
+    for (auto& e : readerEpochs) e.store(0);
+}
+
+ConcurrentTransactionStore::~ConcurrentTransactionStore() {
+    for (auto& r : retired) delete r.second;
+    delete current.load();
+}
+
+// The segment is prepared outside writerMutex: the records already carry
+// their pool handles, and globalStringPool() locks internally for any
+// name a concurrent writer interns at the same time.
+void ConcurrentTransactionStore::append(const Record* batch, int count) {
+    auto segment = make_shared<TransactionSegment>();
+    segment->records.assign(batch, batch + count);
+
+    segment->byDate.resize(count);
+    for (int i = 0; i < count; ++i) segment->byDate[i] = i;
+    vector<int> keys(count);
+    for (int i = 0; i < count; ++i) keys[i] = segment->records[i].dateToInt();
+    stable_sort(segment->byDate.begin(), segment->byDate.end(),
+                [&](int a, int b) { return keys[a] < keys[b]; });
+    segment->columns.build(segment->records.data(), count);
+    segment->dates.resize(count);
+    for (int i = 0; i < count; ++i) segment->dates[i] = keys[segment->byDate[i]];
+    segment->cube.build(segment->records.data(), count);
+
+    lock_guard<mutex> lock(writerMutex);
+    const TransactionSnapshot* old = current.load();
+    TransactionSnapshot* next = new TransactionSnapshot(*old);
+    next->segments.push_back(segment);
+    next->version = old->version + 1;
+    next->size = old->size + count;
+
+    current.store(next);
+    retired.push_back({epoch.fetch_add(1), old});
+    reclaim();
+}
+
+// Frees snapshots retired at epoch t once every active reader entered after t.
+void ConcurrentTransactionStore::reclaim() {
+    uint64_t oldestReader = UINT64_MAX;
+    for (const auto& e : readerEpochs) {
+        uint64_t v = e.load();
+        if (v != 0 && v < oldestReader) oldestReader = v;
+    }
+    size_t kept = 0;
+    for (auto& r : retired) {
+        if (r.first < oldestReader) delete r.second;
+        else retired[kept++] = r;
+    }
+    retired.resize(kept);
+}
+
+int ConcurrentTransactionStore::countOnDate(const string& date) const {
+    int target = dateKey(date);
+    return read([&](const TransactionSnapshot& snap) {
+        int total = 0;
+        for (const auto& seg : snap.segments) {
+            auto range = equal_range(seg->dates.begin(), seg->dates.end(), target);
+            total += range.second - range.first;
+        }
+        return total;
+    });
+}
+
+void ConcurrentTransactionStore::forEachOnDate(const string& date, const function<void(const Record&)>& fn) const {
+    int target = dateKey(date);
+    read([&](const TransactionSnapshot& snap) {
+        for (const auto& seg : snap.segments) {
+            auto range = equal_range(seg->dates.begin(), seg->dates.end(), target);
+            for (auto it = range.first; it != range.second; ++it)
+                fn(seg->records[seg->byDate[it - seg->dates.begin()]]);
+        }
+    });
+}
+
+int ConcurrentTransactionStore::countInDateRange(const string& from, const string& to) const {
+    int lo = dateKey(from);
+    int hi = dateKey(to);
+    return read([&](const TransactionSnapshot& snap) {
+        int total = 0;
+        for (const auto& seg : snap.segments) {
+            auto first = lower_bound(seg->dates.begin(), seg->dates.end(), lo);
+            auto last = upper_bound(seg->dates.begin(), seg->dates.end(), hi);
+            if (last > first) total += last - first;
+        }
+        return total;
+    });
+}
+
+void ConcurrentTransactionStore::categoryPaymentCounts(const string& category, const string& payment,
+                                                       int& total, int& matched, int month) const {
+    read([&](const TransactionSnapshot& snap) {
+        total = matched = 0;
+        StringPool& pool = globalStringPool();
+        int categoryKey = pool.find(category);
+        int paymentKey = pool.find(payment);
+        if (categoryKey < 0) return;
+        for (const auto& seg : snap.segments) {
+            total += seg->cube.cell(categoryKey, TransactionCube::ANY, month).count;
+            if (paymentKey >= 0) matched += seg->cube.cell(categoryKey, paymentKey, month).count;
+        }
+    });
+}
+
+int ConcurrentTransactionStore::countPriceAbove(double price) const {
+    return read([&](const TransactionSnapshot& snap) {
+        int total = 0;
+        for (const auto& seg : snap.segments) {
+            total += scanPriceAbove(seg->columns.price.data(), seg->columns.size(), price);
+        }
+        return total;
+    });
+}
+
+int ConcurrentTransactionStore::size() const {
+    return read([](const TransactionSnapshot& snap) { return snap.size; });
+}
+
+uint64_t ConcurrentTransactionStore::version() const {
+    return read([](const TransactionSnapshot& snap) { return snap.version; });
+}
+
+// Query Server
+QueryThreadPool::QueryThreadPool(int threads) {
+    if (threads < 1) threads = 1;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([this] {
+            while (true) {
+                function<void()> task;
+                {
+                    unique_lock<mutex> lock(mtx);
+                    cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) return;
+                    task = move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        });
+    }
+}
+
+QueryThreadPool::~QueryThreadPool() {
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+void QueryThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> lock(mtx);
+        tasks.push_back(move(task));
+    }
+    cv.notify_one();
+}
+
+static string trimSpaces(const string& s) {
+    size_t b = s.find_first_not_of(" \t");
+    size_t e = s.find_last_not_of(" \t");
+    return b == string::npos ? string() : s.substr(b, e - b + 1);
+}
+
+// "D/M/YYYY" in any zero padding -> YYYYMMDD, the key Record::dateToInt() gives
+static bool parseQueryDate(const string& text, int& key) {
+    int day = 0, month = 0, year = 0;
+    if (sscanf(text.c_str(), "%d/%d/%d", &day, &month, &year) != 3) return false;
+    if (day < 1 || day > 31 || month < 1 || month > 12 || year < 0) return false;
+    key = year * 10000 + month * 100 + day;
+    return true;
+}
+
+// YYYYMMDD -> "DD/MM/YYYY", the spelling used in the CSV
+static string formatQueryDate(int key) {
+    char text[16];
+    snprintf(text, sizeof(text), "%02d/%02d/%04d", key % 100, key / 100 % 100, key / 10000);
+    return text;
+}
+
+// "category,payment[,MM/YYYY]" -> names and YYYYMM (or TransactionCube::ANY)
+static void parseRatioArguments(const string& rest, string& category, string& payment, int& month) {
+    size_t first = rest.find(',');
+    size_t second = first == string::npos ? string::npos : rest.find(',', first + 1);
+    category = trimSpaces(rest.substr(0, first));
+    payment = first == string::npos ? "" : trimSpaces(rest.substr(first + 1, second - first - 1));
+    month = TransactionCube::ANY;
+    if (second != string::npos) {
+        int mm = 0, yyyy = 0;
+        if (sscanf(rest.c_str() + second + 1, "%d/%d", &mm, &yyyy) == 2) month = yyyy * 100 + mm;
+    }
+}
+
+// SEARCH <word>... [OR] [RATING n | RATING lo-hi] [PRODUCT id]
+static ReviewQuery parseSearchArguments(stringstream& in) {
+    ReviewQuery query;
+    string token;
+    while (in >> token) {
+        string upper = token;
+        for (auto& c : upper) c = toupper(c);
+        if (upper == "OR") {
+            query.matchAll = false;
+        } else if (upper == "AND") {
+            query.matchAll = true;
+        } else if (upper == "RATING" && in >> token) {
+            int lo = 1, hi = 5;
+            if (sscanf(token.c_str(), "%d-%d", &lo, &hi) == 1) hi = lo;
+            query.minRating = lo;
+            query.maxRating = hi;
+        } else if (upper == "PRODUCT" && in >> token) {
+            query.product = token;
+        } else {
+            query.terms.push_back(token);
+        }
+    }
+    return query;
+}
+
+// Answers one protocol line; the existing search/analysis functions are the kernels.
+string answerQuery(const QueryServerData& data, const string& line) {
+    stringstream in(line);
+    string command;
+    in >> command;
+    for (auto& c : command) c = toupper(c);
+
+    stringstream out;
+    if (command == "DATE") {
+        string date;
+        in >> date;
+        int target = 0;
+        int found = 0;
+        // Matches by date value, so 9/5/2023 and 09/05/2023 find the same rows.
+        // Served from the store like RANGE/RATIO/PRICE, so appended batches show up.
+        if (parseQueryDate(date, target)) {
+            date = formatQueryDate(target);
+            data.store.forEachOnDate(date, [&](const Record& r) {
+                out << "Customer ID: " << r.customerID << ",Product: " << r.product
+                    << ",Category: " << r.category << ",Price: $" << r.price
+                    << ",Date: " << r.date << ",Payment Method: " << r.paymentMethod << "\n";
+                found++;
+            });
+        }
+        out << "Transactions found on " << date << ": " << found << "\n";
+    } else if (command == "RANGE") {
+        string from, to;
+        in >> from >> to;
+        int lo = 0, hi = 0;
+        int count = 0;
+        if (parseQueryDate(from, lo) && parseQueryDate(to, hi)) {
+            from = formatQueryDate(lo);
+            to = formatQueryDate(hi);
+            count = data.store.countInDateRange(from, to);
+        }
+        out << "Transactions from " << from << " to " << to << ": " << count << "\n";
+    } else if (command == "RATIO") {
+        // RATIO <category>,<payment method>[,MM/YYYY]
+        string rest;
+        getline(in >> ws, rest);
+        string category, payment;
+        int month;
+        parseRatioArguments(rest, category, payment, month);
+        int total = 0, matched = 0;
+        data.store.categoryPaymentCounts(category, payment, total, matched, month);
+        double percentage = total > 0 ? matched * 100.0 / total : 0.0;
+        out << category << " paid via " << payment;
+        if (month != TransactionCube::ANY) out << " in " << month % 100 << "/" << month / 100;
+        out << ": " << matched << " / " << total
+            << " (" << fixed << setprecision(2) << percentage << "%)\n";
+    } else if (command == "WORDS") {
+        int rating = 1, limit = 10;
+        in >> rating >> limit;
+        auto wordFreq = countWordFrequencies(data.reviews, data.reviewCount, rating);
+        multimap<int, string, greater<int>> sortedWords;
+        for (const auto& pair : wordFreq) sortedWords.insert({pair.second, pair.first});
+        int shown = 0;
+        for (const auto& [freq, word] : sortedWords) {
+            if (shown++ == limit) break;
+            out << word << ": " << freq << "\n";
+        }
+        if (sortedWords.empty()) out << "No " << rating << "-star reviews found.\n";
+    } else if (command == "SEARCH") {
+        ReviewQuery query = parseSearchArguments(in);
+        vector<uint32_t> ids = data.textIndex.search(query);
+        int shown = 0;
+        for (uint32_t id : ids) {
+            if (shown++ == 10) break;
+            const Review& r = data.reviews[id];
+            out << "Review #" << id << " (" << r.rating << " stars, " << r.product_id << ", "
+                << r.customer_id << "): " << r.review << "\n";
+        }
+        out << "Matching reviews: " << ids.size() << "\n";
+    } else if (command == "PRICE") {
+        double price = 0;
+        in >> price;
+        out << "Transactions priced above $" << price << ": " << data.store.countPriceAbove(price) << "\n";
+    } else if (command == "STATS") {
+        out << "Cache: " << data.cache.size() << " entries, " << data.cache.hits() << " hits, "
+            << data.cache.misses() << " misses\n";
+    } else {
+        out << "Unknown command. Use DATE, RANGE, RATIO, PRICE, WORDS, SEARCH, STATS or QUIT.\n";
+    }
+    return out.str();
+}
+
+// Query Result Cache
+bool QueryResultCache::lookup(const string& key, uint64_t version, string& result) {
+    lock_guard<mutex> lock(mtx);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        missCount++;
+        return false;
+    }
+    if (it->second->version != version) {     // computed before the last append
+        entries.erase(it->second);
+        index.erase(it);
+        missCount++;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    result = it->second->result;
+    hitCount++;
+    return true;
+}
+
+void QueryResultCache::insert(const string& key, uint64_t version, const string& result) {
+    if (capacity == 0) return;
+    lock_guard<mutex> lock(mtx);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        entries.erase(it->second);
+        index.erase(it);
+    }
+    entries.push_front({key, version, result});
+    index[key] = entries.begin();
+    if (entries.size() > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+void QueryResultCache::clear() {
+    lock_guard<mutex> lock(mtx);
+    entries.clear();
+    index.clear();
+}
+
+size_t QueryResultCache::size() {
+    lock_guard<mutex> lock(mtx);
+    return entries.size();
+}
+
+// Canonical cache key: upper-case command, dates as YYYYMMDD, names trimmed.
+// Returns an empty string for lines that should not be cached.
+string normalizeQuery(const string& line) {
+    stringstream in(line);
+    string command;
+    in >> command;
+    for (auto& c : command) c = toupper(c);
+
+    // Same date parsing as answerQuery, which replies with the canonical
+    // date; anything it cannot parse is answered uncached
+    if (command == "DATE") {
+        string date;
+        int key;
+        in >> date;
+        return parseQueryDate(date, key) ? "DATE " + to_string(key) : "";
+    }
+    if (command == "RANGE") {
+        string from, to;
+        int lo, hi;
+        in >> from >> to;
+        if (!parseQueryDate(from, lo) || !parseQueryDate(to, hi)) return "";
+        return "RANGE " + to_string(lo) + " " + to_string(hi);
+    }
+    if (command == "RATIO") {
+        string rest, category, payment;
+        int month;
+        getline(in >> ws, rest);
+        parseRatioArguments(rest, category, payment, month);
+        return "RATIO " + category + "|" + payment + "|" + to_string(month);
+    }
+    if (command == "PRICE") {
+        double price = 0;
+        in >> price;
+        return "PRICE " + to_string(price);
+    }
+    if (command == "WORDS") {
+        int rating = 1, limit = 10;
+        in >> rating >> limit;
+        return "WORDS " + to_string(rating) + " " + to_string(limit);
+    }
+    if (command == "SEARCH") {
+        ReviewQuery query = parseSearchArguments(in);
+        string key = "SEARCH ";
+        vector<string> terms;
+        for (const string& word : query.terms) forEachTerm(word, [&](const string& t) { terms.push_back(t); });
+        sort(terms.begin(), terms.end());
+        for (const string& t : terms) key += t + " ";
+        return key + (query.matchAll ? "AND " : "OR ") + to_string(query.minRating) + "-" +
+               to_string(query.maxRating) + " " + query.product;
+    }
+    return "";
+}
+
+string answerQueryCached(const QueryServerData& data, const string& line) {
+    string key = normalizeQuery(line);
+    if (key.empty()) return answerQuery(data, line);
+
+    // Review queries depend on the review data, everything else on transactions
+    bool reviewQuery = key.compare(0, 5, "WORDS") == 0 || key.compare(0, 6, "SEARCH") == 0;
+    uint64_t version = reviewQuery ? data.reviewVersion.load() : data.store.version();
+    string result;
+    if (data.cache.lookup(key, version, result)) return result;
+    result = answerQuery(data, line);
+    data.cache.insert(key, version, result);
+    return result;
+}
+
+bool loadQueryServerData(QueryServerData& data, const string& transactionFile, const string& reviewFile,
+                         int threads) {
+    data.transactionCount = readTransactionCSVParallel(transactionFile, data.transactions, threads);
+    if (data.transactionCount == 0) {
+        cerr << "Failed to load transaction data." << endl;
+        return false;
+    }
+    data.reviewCount = readReviewCSVParallel(reviewFile, data.reviews, threads);
+    buildReviewTextIndex(data.reviews, data.reviewCount, data.textIndex);
+    data.store.append(data.transactions, data.transactionCount);
+    return true;
+}
+
+// Loads and indexes once, then serves one query per stdin line until QUIT/EOF.
+// Replies are tagged with the query number since they may finish out of order.
+int runQueryServer(const string& transactionFile, const string& reviewFile, int threads) {
+    QueryServerData data;
+    if (!loadQueryServerData(data, transactionFile, reviewFile, threads)) return 1;
+
+    cout << "Ready: " << data.transactionCount << " transactions, " << data.reviewCount
+         << " reviews. Commands: DATE d | RANGE d1 d2 | RATIO category,payment[,MM/YYYY] | PRICE min | WORDS rating [limit] | SEARCH words [OR] [RATING lo-hi] [PRODUCT id] | STATS | QUIT"
+         << endl;
+
+    mutex outputMutex;
+    {
+        QueryThreadPool pool(threads);
+        string line;
+        int queryId = 0;
+        while (getline(cin, line)) {
+            if (line.empty()) continue;
+            if (line == "QUIT" || line == "quit") break;
+            int id = ++queryId;
+            pool.submit([&data, &outputMutex, line, id] {
+                auto start = high_resolution_clock::now();
+                string reply = answerQueryCached(data, line);
+                auto end = high_resolution_clock::now();
+                double ms = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+                lock_guard<mutex> lock(outputMutex);
+                cout << "[#" << id << "] " << line << "\n" << reply
+                     << "[#" << id << "] " << fixed << setprecision(3) << ms << " ms\n" << flush;
+            });
+        }
+    }   // pool drains outstanding queries here
+
+    delete[] data.transactions;
+    delete[] data.reviews;
+    return 0;
+}
 
 // Q1 FULL
 int main() {
@@ -445,16 +1725,17 @@ int main() {
 
         int totalFound = right - (left + 1);
 
+        OutputWriter out;
         for (int i = left + 1; i < right; ++i) {
-            cout << "Customer ID: " << transactions[i].customerID <<  ",";
-            cout << "Product: " << transactions[i].product <<  ",";
-            cout << "Category: " << transactions[i].category <<  ",";
-            cout << "Price: $" << transactions[i].price <<  ",";
-            cout << "Date: " << transactions[i].date <<  ",";
-            cout << "Payment Method: " << transactions[i].paymentMethod << "\n";
+            out << "Customer ID: " << transactions[i].customerID << ',';
+            out << "Product: " << transactions[i].product << ',';
+            out << "Category: " << transactions[i].category << ',';
+            out << "Price: $" << transactions[i].price << ',';
+            out << "Date: " << transactions[i].date << ',';
+            out << "Payment Method: " << transactions[i].paymentMethod << '\n';
         }
 
-        cout << "\nTransactions found on " << targetDate << ": " << totalFound << "\n";
+        out << "\nTransactions found on " << targetDate << ": " << totalFound << "\n";
 
     } else {
         cout << "No transaction found on that date.\n";
@@ -470,6 +1751,148 @@ int main() {
 
 
 
+// // SERVER
+// int main() {
+//     // Example session:
+//     //   DATE 09/05/2023
+//     //   RANGE 01/01/2023 31/03/2023
+//     //   RATIO Electronics,Credit Card
+//     //   RATIO Electronics,Credit Card,05/2023
+//     //   PRICE 1500
+//     //   WORDS 1 20
+//     //   SEARCH damaged replacement RATING 1-2
+//     //   STATS
+//     //   QUIT
+//     return runQueryServer("transactions_cleaned.csv", "reviews_cleaned.csv", defaultThreadCount());
+// }
+
+
+
+// // SERVER CHECK
+// int main() {
+//     // Each pair spells one query two ways. The second is answered from the
+//     // cache entry of the first and must equal a fresh, uncached answer.
+//     QueryServerData data;
+//     if (!loadQueryServerData(data, "transactions_cleaned.csv", "reviews_cleaned.csv", 1)) return 1;
+
+//     vector<pair<string, string>> spellings = {
+//         {"DATE 9/5/2023", "DATE 09/05/2023"},
+//         {"DATE 09/05/2023", "date 9/05/2023"},
+//         {"RANGE 1/1/2023 31/3/2023", "RANGE 01/01/2023 31/03/2023"},
+//         {"RATIO Electronics , Credit Card", "RATIO Electronics,Credit Card"},
+//         {"WORDS 1 5", "words 1 5"},
+//     };
+
+//     int failures = 0;
+//     for (const auto& [first, second] : spellings) {
+//         answerQueryCached(data, first);
+//         string cached = answerQueryCached(data, second);
+//         string fresh = answerQuery(data, second);
+//         if (cached != fresh) {
+//             failures++;
+//             cout << "FAIL: \"" << second << "\" after \"" << first << "\"\n"
+//                  << "cached:\n" << cached << "fresh:\n" << fresh;
+//         }
+//     }
+//     cout << (failures ? to_string(failures) + " server check(s) failed" : "All server checks passed") << "\n";
+
+//     delete[] data.transactions;
+//     delete[] data.reviews;
+//     return failures ? 1 : 0;
+// }
+
+
+
+// // STORE CHECK
+// int main() {
+//     // Writers append batches whose category and payment names are new to
+//     // the pool while readers query; every count must add up afterwards.
+//     const int writers = 4, batches = 50, batchSize = 20;
+//     ConcurrentTransactionStore store;
+//     atomic<bool> done{false};
+
+//     vector<thread> threads;
+//     for (int w = 0; w < writers; ++w) {
+//         threads.emplace_back([&, w] {
+//             vector<Record> batch(batchSize);
+//             for (int b = 0; b < batches; ++b) {
+//                 for (int i = 0; i < batchSize; ++i) {
+//                     Record& r = batch[i];
+//                     r.customerID = "C" + to_string(w) + "-" + to_string(b * batchSize + i);
+//                     r.product = "Product " + to_string(i);
+//                     r.category = "Category " + to_string(w) + "-" + to_string(b);
+//                     r.price = i;
+//                     r.date = to_string(i % 28 + 1) + "/" + to_string(w + 1) + "/2024";
+//                     r.paymentMethod = "Payment " + to_string(w);
+//                 }
+//                 store.append(batch.data(), batchSize);
+//             }
+//         });
+//     }
+//     for (int r = 0; r < 2; ++r) {
+//         threads.emplace_back([&] {
+//             while (!done.load()) store.countInDateRange("01/01/2024", "31/12/2024");
+//         });
+//     }
+//     for (int w = 0; w < writers; ++w) threads[w].join();
+//     done.store(true);
+//     for (size_t t = writers; t < threads.size(); ++t) threads[t].join();
+
+//     int failures = 0;
+//     auto expect = [&](const string& what, int got, int want) {
+//         if (got != want) {
+//             failures++;
+//             cout << "FAIL: " << what << " = " << got << ", expected " << want << "\n";
+//         }
+//     };
+//     expect("size", store.size(), writers * batches * batchSize);
+//     expect("version", (int)store.version(), writers * batches);
+//     expect("range", store.countInDateRange("01/01/2024", "31/12/2024"), writers * batches * batchSize);
+//     for (int w = 0; w < writers; ++w) {
+//         expect("on 1/" + to_string(w + 1), store.countOnDate("1/" + to_string(w + 1) + "/2024"), batches);
+//         for (int b = 0; b < batches; ++b) {
+//             string category = "Category " + to_string(w) + "-" + to_string(b);
+//             int total, matched;
+//             store.categoryPaymentCounts(category, "Payment " + to_string(w), total, matched);
+//             expect(category, total, batchSize);
+//             expect(category + " / Payment " + to_string(w), matched, batchSize);
+//         }
+//     }
+//     cout << (failures ? to_string(failures) + " store check(s) failed" : "All store checks passed") << "\n";
+//     return failures ? 1 : 0;
+// }
+
+
+
+// // COLUMNAR
+// int main() {
+//     // Convert once; every reader above then accepts the .col files in place of the CSVs
+//     Record* transactions;
+//     int transactionCount = readTransactionCSV("transactions_cleaned.csv", transactions);
+//     saveTransactionsColumnar("transactions.col", transactions, transactionCount);
+//     delete[] transactions;
+
+//     auto start = high_resolution_clock::now();
+
+//     // Only row groups whose date range and Bloom filters can match are read
+//     TransactionPredicate pred;
+//     pred.category = "Electronics";
+//     pred.paymentMethod = "Credit Card";
+//     ColumnarScanInfo scan;
+//     int matches = readTransactionColumnar("transactions.col", transactions, pred, &scan);
+
+//     auto end = high_resolution_clock::now();
+//     cout << "Electronics / Credit Card: " << matches << " rows, " << scan.rowGroupsRead << " of "
+//          << scan.rowGroups << " row groups read\n";
+//     cout << "Execution Time: " << duration_cast<milliseconds>(end - start).count() << " ms\n";
+
+//     delete[] transactions;
+//     return 0;
+// }
+
+
+
+
 
 // //Q1 COMPARE
 // int main() {
@@ -485,6 +1908,8 @@ int main() {
 //     // bubbleSort(transactions, transactionCount, BY_DATE);
 //     // selectionSort(transactions, transactionCount, BY_CATEGORY);
 //     // insertionSort(transactions, transactionCount, BY_PRICE);
+//     // introSort(transactions, transactionCount, BY_DATE);  // in place, unstable
+//     // timSort(transactions, transactionCount, BY_DATE);    // stable, fast on presorted runs
 //     mergeSort(transactions, 0, transactionCount - 1, BY_DATE);  // You can change to BY_CATEGORY or BY_PRICE
 
 //     // === DISPLAY SORTED TRANSACTIONS ===
@@ -507,8 +1932,10 @@ int main() {
 
 // //Q2 FULL
 // int main() {
+//     // The cube is filled while loading, so the query itself is two lookups
 //     Record* transactions;
-//     int transactionCount = readTransactionCSV("transactions_cleaned.csv", transactions);
+//     TransactionCube cube;
+//     int transactionCount = readTransactionCSVParallel("transactions_cleaned.csv", transactions, 1, nullptr, &cube);
 //     if (transactionCount == 0) {
 //         cerr << "Failed to load transaction data." << endl;
 //         return 1;
@@ -516,7 +1943,11 @@ int main() {
 
 //     auto start = high_resolution_clock::now();
 
-//     processElectronicsCreditCardPercentage(transactions, transactionCount);
+//     processElectronicsCreditCardPercentage(cube);
+//     // or, on bitmap indexes built at load time:
+//     // TransactionBitmaps bitmaps;
+//     // buildTransactionBitmaps(transactions, transactionCount, bitmaps);
+//     // processElectronicsCreditCardPercentage(bitmaps);
 
 //     auto end = high_resolution_clock::now();
 //     cout << "\nExecution Time: " << duration_cast<milliseconds>(end - start).count() << " ms\n";
@@ -538,16 +1969,15 @@ int main() {
 //     if (reviewCount == 0) return 1;
 
 //     // Extract and sort 1-star reviews by review text
-//     Review* oneStarReviews = new Review[reviewCount];
-//     int oneStarCount = 0;
-//     for (int i = 0; i < reviewCount; ++i) {
-//         if (reviews[i].rating == 1) {
-//             oneStarReviews[oneStarCount++] = reviews[i];
-//         }
-//     }
+//     // (1-star reviews from buyers only: RoaringBitmap::andOf(oneStar, bitmaps.hasTransaction))
+//     ReviewBitmaps bitmaps;
+//     buildReviewBitmaps(reviews, reviewCount, transactions, transactionCount, bitmaps);
+//     Review* oneStarReviews;
+//     int oneStarCount = selectReviews(reviews, bitmaps.rating.rowsWith(1), oneStarReviews);
 
 //     if (oneStarCount > 0) {
 //         mergeSortR(oneStarReviews, 0, oneStarCount - 1);
+//         // multikeySortR(oneStarReviews, 0, oneStarCount - 1);  // same order, prefix-cached string sort
 
 //         cout << "\n=== Sorted 1-Star Reviews (by review text) ===\n";
 //         for (int i = 0; i < oneStarCount; ++i) {
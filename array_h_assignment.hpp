@@ -2,29 +2,62 @@
 #define ARRAY_ASSIGNMENT_HPP
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <deque>
+#include <list>
+#include <functional>
+#include <condition_variable>
+#include "intern_h_pool.hpp"
+#include "packed_h_record.hpp"
+#include "cube_h_transactions.hpp"
+#include "scan_h_kernels.hpp"
+#include "bitmap_h_index.hpp"
+#include "join_h_customers.hpp"
+#include "text_h_index.hpp"
+#include "ngram_h_sketch.hpp"
+#include "stats_h_sketches.hpp"
+#include "bucket_h_sort.hpp"
+#include "string_h_sort.hpp"
+#include "columnar_h_store.hpp"
+#include "output_h_writer.hpp"
 
 
 
 using namespace std;
 
+// "DD/MM/YYYY" (any zero padding) -> YYYYMMDD; missing parts count as 0
+inline int dateKey(string_view date) {
+    int parts[3] = {0, 0, 0};
+    size_t i = 0;
+    for (int& part : parts) {
+        while (i < date.size() && date[i] >= '0' && date[i] <= '9') part = part * 10 + (date[i++] - '0');
+        if (i < date.size() && date[i] == '/') ++i;
+    }
+    return parts[2] * 10000 + parts[1] * 100 + parts[0];
+}
+
+// Every text field except review bodies is an InternedString: 4 bytes of
+// handle per field, characters shared through globalStringPool().
 struct Record {
-    string customerID;
-    string product;
-    string category;
+    InternedString customerID;
+    InternedString product;
+    InternedString category;
     double price;
-    string date;
-    string paymentMethod;
+    InternedString date;
+    InternedString paymentMethod;
 
-    int dateToInt() const {
-        int day, month, year;
-        sscanf(date.c_str(), "%d/%d/%d", &day, &month, &year);
-        return year * 10000 + month * 100 + day;
-    }
+    int dateToInt() const { return dateKey(date); }
 };
 
 struct Review {
-    string product_id;
-    string customer_id;
+    InternedString product_id;
+    InternedString customer_id;
     int rating;
     string review;
 };
@@ -35,6 +68,16 @@ enum SortMode {
     BY_PRICE
 };
 
+// Read-only ordering of a Record array through a permutation from argsort.
+// Several views can share one array, 4 bytes per row each.
+struct RecordView {
+    const Record* records;
+    const int32_t* order;
+    int size;
+
+    const Record& operator[](int i) const { return records[order[i]]; }
+};
+
 
 
 
@@ -44,22 +87,244 @@ void bubbleSort(Record* arr, int size, SortMode mode);
 void insertionSort(Record* arr, int size, SortMode mode);
 void selectionSort(Record* arr, int size, SortMode mode);
 void mergeSort(Record* arr, int left, int right, SortMode mode);
+void introSort(Record* arr, int size, SortMode mode);   // pattern-defeating quicksort, unstable
+void timSort(Record* arr, int size, SortMode mode);     // stable, adaptive to sorted runs
+
+// Sorting on the packed layout (see packed_h_record.hpp)
+bool compareRecords(const PackedRecord& a, const PackedRecord& b, SortMode mode);
+void bubbleSort(PackedRecord* arr, int size, SortMode mode);
+void insertionSort(PackedRecord* arr, int size, SortMode mode);
+void selectionSort(PackedRecord* arr, int size, SortMode mode);
+void mergeSort(PackedRecord* arr, int left, int right, SortMode mode);
+void introSort(PackedRecord* arr, int size, SortMode mode);
+void timSort(PackedRecord* arr, int size, SortMode mode);
+PackedRecord* packRecords(const Record* arr, int size);
+Record* unpackRecords(const PackedRecord* arr, int size);
+
+// Top-K (largest first, returns new[] array of min(k, size) records)
+Record* topK(Record* arr, int size, int k, SortMode mode);
+Record* topKParallel(Record* arr, int size, int k, SortMode mode, int threads);
 
 // Searching
 int linearSearch(Record* arr, int size, const string& targetDate);
+int linearSearch(const TransactionColumns& columns, const string& targetDate);
 int binarySearch(Record* arr, int size, const string& target, SortMode mode);
 int interpolationSearch(Record* arr, int size, const string& targetDate);
 int jumpSearch(Record* arr, int size, const string& targetDate);
+int binarySearch(const RecordView& view, const string& target, SortMode mode);
+int interpolationSearch(const RecordView& view, const string& targetDate);
+int jumpSearch(const RecordView& view, const string& targetDate);
+
+// Argsort (permutation instead of moving records)
+vector<int32_t> argsort(const Record* arr, int size, SortMode mode);
+vector<int32_t> argsortByText(const Record* arr, int size, InternedString Record::*field);
 
 // Utilities
 int readTransactionCSV(const string& filename, Record*& arr);
 int readReviewCSV(const string& filename, Review*& arr);
+bool parseTransactionRow(string_view line, Record& record);
+bool parseReviewRow(string_view line, Review& review);
+int readTransactionCSVParallel(const string& filename, Record*& arr, int threads, TransactionStats* stats = nullptr,
+                               TransactionCube* cube = nullptr);
+int readReviewCSVParallel(const string& filename, Review*& arr, int threads);
 void displayTransactions(Record* arr, int size);
-void processElectronicsCreditCardPercentage(Record* transactions, int size);
+void processElectronicsCreditCardPercentage(const TransactionCube& cube);   // cube from the loader
+void displayTransactionStats(const TransactionStats& stats);
+
+// Columnar Storage (see columnar_h_store.hpp)
+// The CSV readers above detect columnar files and load them as well; these
+// take a predicate so row groups that cannot match are never read.
+bool saveTransactionsColumnar(const string& filename, const Record* arr, int size);
+bool saveReviewsColumnar(const string& filename, const Review* arr, int size);
+int readTransactionColumnar(const string& filename, Record*& arr,
+                            const TransactionPredicate& pred = TransactionPredicate(), ColumnarScanInfo* scan = nullptr);
+int readReviewColumnar(const string& filename, Review*& arr,
+                       const ReviewPredicate& pred = ReviewPredicate(), ColumnarScanInfo* scan = nullptr);
 
 // Review Processing
 int filterReviews(Review*& reviews, int reviewCount, Record* transactions, int transCount);
+unordered_map<string, int> countWordFrequencies(const Review* reviews, int count, int rating);
 void analyzeOneStarReviews(Review* reviews, int count);
+void analyzeReviewNGrams(const Review* reviews, int count, const NGramOptions& options, int limit);
 void mergeSortR(Review* arr, int left, int right);
+void multikeySortR(Review* arr, int left, int right);   // same order as mergeSortR
+void countingSortReviews(Review*& arr, int count, ReviewSortKey key, bool descending);   // stable
+void countingSortByReviewLength(Review*& arr, int count);   // longest first, ties in reverse input order
+void buildReviewTextIndex(const Review* reviews, int count, ReviewTextIndex& index);  // indexes reviews not yet in `index`
+
+// Bitmap Indexes (row IDs per value, see bitmap_h_index.hpp)
+struct TransactionBitmaps {
+    ColumnBitmapIndex category;     // keyed by category handle
+    ColumnBitmapIndex payment;      // keyed by payment handle
+    int rows = 0;
+};
+
+struct ReviewBitmaps {
+    ColumnBitmapIndex rating;
+    RoaringBitmap hasTransaction;   // reviews whose customer bought something
+    int rows = 0;
+};
+
+void buildTransactionBitmaps(Record* transactions, int size, TransactionBitmaps& index);
+void buildReviewBitmaps(Review* reviews, int reviewCount, Record* transactions, int transCount, ReviewBitmaps& index);
+void processElectronicsCreditCardPercentage(const TransactionBitmaps& index);
+int selectReviews(const Review* reviews, const RoaringBitmap& rows, Review*& out);
+
+// Customer Join (see join_h_customers.hpp)
+// Pairs are (review index, transaction index), in review order.
+vector<JoinPair> joinReviewsToTransactions(Review* reviews, int reviewCount, Record* transactions, int transCount,
+                                           int threads = 1);
+void forEachReviewTransaction(Review* reviews, int reviewCount, Record* transactions, int transCount,
+                              const function<void(const Review&, const Record&)>& fn);
+
+// Concurrent Store
+// Readers query an immutable snapshot without taking locks. Writers build a
+// new snapshot that shares the old segments plus one new segment, publish it
+// with a single pointer store, and free old snapshots once no reader that
+// could still see them is active (epoch-based reclamation).
+
+// One appended batch; never modified after it is published.
+struct TransactionSegment {
+    vector<Record> records;
+    vector<int> dates;      // ascending; dates[i] belongs to records[byDate[i]]
+    vector<int> byDate;
+    TransactionColumns columns;     // same row order as records
+    TransactionCube cube;           // this segment's records only; readers sum over segments
+};
+
+// Publishing copies only the segment pointers, so an append costs the size
+// of its own batch, not of everything stored before it.
+struct TransactionSnapshot {
+    vector<shared_ptr<const TransactionSegment>> segments;
+    uint64_t version = 0;
+    int size = 0;
+};
+
+class ConcurrentTransactionStore {
+public:
+    static const int MAX_READERS = 64;
+
+    ConcurrentTransactionStore();
+    ~ConcurrentTransactionStore();
+    ConcurrentTransactionStore(const ConcurrentTransactionStore&) = delete;
+    ConcurrentTransactionStore& operator=(const ConcurrentTransactionStore&) = delete;
+
+    // Writers are serialised with each other; readers never wait for them.
+    void append(const Record* batch, int count);
+
+    // Runs fn(const TransactionSnapshot&) on a stable snapshot, lock-free.
+    template <typename Fn>
+    auto read(Fn fn) const {
+        ReaderGuard guard(*this);
+        return fn(*guard.snapshot);
+    }
+
+    int countOnDate(const string& date) const;
+    // Calls fn for each record on date: segment by segment, in input order within a day
+    void forEachOnDate(const string& date, const function<void(const Record&)>& fn) const;
+    int countInDateRange(const string& from, const string& to) const;
+    // month is YYYYMM, or TransactionCube::ANY for all time
+    void categoryPaymentCounts(const string& category, const string& payment,
+                               int& total, int& matched, int month = TransactionCube::ANY) const;
+    int countPriceAbove(double price) const;
+    int size() const;
+    uint64_t version() const;
+
+private:
+    struct ReaderGuard {
+        const ConcurrentTransactionStore& store;
+        int slot = -1;
+        const TransactionSnapshot* snapshot = nullptr;
+
+        explicit ReaderGuard(const ConcurrentTransactionStore& s) : store(s) {
+            uint64_t e = store.epoch.load();
+            for (int i = 0;; i = (i + 1) % MAX_READERS) {
+                uint64_t idle = 0;
+                if (store.readerEpochs[i].compare_exchange_strong(idle, e)) {
+                    slot = i;
+                    break;
+                }
+                if (i == MAX_READERS - 1) this_thread::yield();
+            }
+            snapshot = store.current.load();
+        }
+        ~ReaderGuard() { store.readerEpochs[slot].store(0); }
+    };
+
+    atomic<const TransactionSnapshot*> current;
+    atomic<uint64_t> epoch;
+    mutable atomic<uint64_t> readerEpochs[MAX_READERS];   // 0 = idle
+
+    mutex writerMutex;
+    vector<pair<uint64_t, const TransactionSnapshot*>> retired;
+
+    void reclaim();
+};
+
+// Query Server
+// Resident mode: load and index once, then answer line-based queries from
+// stdin on a thread pool (see runQueryServer for the protocol).
+
+class QueryThreadPool {
+public:
+    explicit QueryThreadPool(int threads);
+    ~QueryThreadPool();     // finishes queued tasks before returning
+    void submit(function<void()> task);
+
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex mtx;
+    condition_variable cv;
+    bool stopping = false;
+};
+
+// Bounded LRU cache of query replies. Each entry remembers the data version
+// it was computed against; a lookup under a newer version is a miss and
+// drops the stale entry, so appends invalidate without a sweep.
+class QueryResultCache {
+public:
+    explicit QueryResultCache(size_t capacity = 1024) : capacity(capacity) {}
+
+    bool lookup(const string& key, uint64_t version, string& result);
+    void insert(const string& key, uint64_t version, const string& result);
+    void clear();
+
+    uint64_t hits() const { return hitCount.load(); }
+    uint64_t misses() const { return missCount.load(); }
+    size_t size();
+
+private:
+    struct Entry {
+        string key;
+        uint64_t version;
+        string result;
+    };
+
+    size_t capacity;
+    list<Entry> entries;                                // most recent first
+    unordered_map<string, list<Entry>::iterator> index;
+    mutex mtx;
+    atomic<uint64_t> hitCount{0};
+    atomic<uint64_t> missCount{0};
+};
+
+struct QueryServerData {
+    Record* transactions = nullptr;     // as loaded; queries read the store
+    int transactionCount = 0;
+    Review* reviews = nullptr;
+    int reviewCount = 0;
+    ConcurrentTransactionStore store;
+    atomic<uint64_t> reviewVersion{0};  // bump whenever reviews are appended
+    ReviewTextIndex textIndex;
+    mutable QueryResultCache cache;
+};
+
+string normalizeQuery(const string& line);
+string answerQuery(const QueryServerData& data, const string& line);
+string answerQueryCached(const QueryServerData& data, const string& line);
+bool loadQueryServerData(QueryServerData& data, const string& transactionFile, const string& reviewFile,
+                         int threads);
+int runQueryServer(const string& transactionFile, const string& reviewFile, int threads);
 
 #endif // ARRAY_ASSIGNMENT_HPP
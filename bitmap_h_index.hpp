@@ -0,0 +1,277 @@
+#ifndef BITMAP_INDEX_HPP
+#define BITMAP_INDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <initializer_list>
+
+using namespace std;
+
+// ---------------- Compressed Bitmap (roaring-style) ----------------
+// Row IDs are split on their high 16 bits into containers. A container
+// holds a sorted uint16 array while it is sparse (<= 4096 values) and a
+// 65536-bit bitset once it is dense, so both rare and common values stay
+// compact. AND / OR / cardinality work container by container.
+
+class RoaringBitmap {
+public:
+    static const int ARRAY_LIMIT = 4096;
+    static const int BITSET_WORDS = 1024;
+
+    void add(uint32_t x) {
+        Container& c = containerFor((uint16_t)(x >> 16));
+        c.add((uint16_t)(x & 0xFFFF));
+    }
+
+    bool contains(uint32_t x) const {
+        const Container* c = findContainer((uint16_t)(x >> 16));
+        return c && c->contains((uint16_t)(x & 0xFFFF));
+    }
+
+    uint64_t cardinality() const {
+        uint64_t total = 0;
+        for (const auto& c : containers) total += c.cardinality;
+        return total;
+    }
+
+    bool empty() const { return cardinality() == 0; }
+
+    // Calls fn(rowId) in increasing order.
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const auto& c : containers) {
+            uint32_t high = (uint32_t)c.key << 16;
+            if (c.isBitset) {
+                for (int w = 0; w < BITSET_WORDS; ++w) {
+                    uint64_t word = c.bits[w];
+                    while (word) {
+                        fn(high | (uint32_t)(w * 64 + __builtin_ctzll(word)));
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (uint16_t v : c.values) fn(high | v);
+            }
+        }
+    }
+
+    static RoaringBitmap andOf(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() && j < b.containers.size()) {
+            const Container& x = a.containers[i];
+            const Container& y = b.containers[j];
+            if (x.key < y.key) ++i;
+            else if (y.key < x.key) ++j;
+            else {
+                Container c = Container::intersect(x, y);
+                if (c.cardinality > 0) result.containers.push_back(move(c));
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    // |a AND b| without building the result.
+    static uint64_t andCardinality(const RoaringBitmap& a, const RoaringBitmap& b) {
+        uint64_t total = 0;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() && j < b.containers.size()) {
+            const Container& x = a.containers[i];
+            const Container& y = b.containers[j];
+            if (x.key < y.key) ++i;
+            else if (y.key < x.key) ++j;
+            else {
+                total += Container::intersectCount(x, y);
+                ++i;
+                ++j;
+            }
+        }
+        return total;
+    }
+
+    static RoaringBitmap orOf(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() || j < b.containers.size()) {
+            if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key)) {
+                result.containers.push_back(a.containers[i++]);
+            } else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key) {
+                result.containers.push_back(b.containers[j++]);
+            } else {
+                result.containers.push_back(Container::unite(a.containers[i++], b.containers[j++]));
+            }
+        }
+        return result;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = 0;
+        for (const auto& c : containers) bytes += c.values.capacity() * 2 + c.bits.capacity() * 8;
+        return bytes;
+    }
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        bool isBitset = false;
+        int cardinality = 0;
+        vector<uint16_t> values;    // sorted, when !isBitset
+        vector<uint64_t> bits;      // BITSET_WORDS words, when isBitset
+
+        bool contains(uint16_t v) const {
+            if (isBitset) return (bits[v >> 6] >> (v & 63)) & 1;
+            return binary_search(values.begin(), values.end(), v);
+        }
+
+        void add(uint16_t v) {
+            if (isBitset) {
+                uint64_t bit = 1ULL << (v & 63);
+                if (!(bits[v >> 6] & bit)) {
+                    bits[v >> 6] |= bit;
+                    cardinality++;
+                }
+                return;
+            }
+            if (values.empty() || values.back() < v) {
+                values.push_back(v);        // row IDs usually arrive in order
+            } else {
+                auto it = lower_bound(values.begin(), values.end(), v);
+                if (it != values.end() && *it == v) return;
+                values.insert(it, v);
+            }
+            cardinality++;
+            if (cardinality > ARRAY_LIMIT) toBitset();
+        }
+
+        void toBitset() {
+            bits.assign(BITSET_WORDS, 0);
+            for (uint16_t v : values) bits[v >> 6] |= 1ULL << (v & 63);
+            vector<uint16_t>().swap(values);
+            isBitset = true;
+        }
+
+        void toArrayIfSparse() {
+            if (!isBitset || cardinality > ARRAY_LIMIT) return;
+            values.clear();
+            values.reserve(cardinality);
+            for (int w = 0; w < BITSET_WORDS; ++w) {
+                uint64_t word = bits[w];
+                while (word) {
+                    values.push_back((uint16_t)(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+            vector<uint64_t>().swap(bits);
+            isBitset = false;
+        }
+
+        static Container intersect(const Container& x, const Container& y) {
+            Container c;
+            c.key = x.key;
+            if (x.isBitset && y.isBitset) {
+                c.isBitset = true;
+                c.bits.resize(BITSET_WORDS);
+                for (int w = 0; w < BITSET_WORDS; ++w) {
+                    c.bits[w] = x.bits[w] & y.bits[w];
+                    c.cardinality += __builtin_popcountll(c.bits[w]);
+                }
+                c.toArrayIfSparse();
+            } else if (x.isBitset || y.isBitset) {
+                const Container& arr = x.isBitset ? y : x;
+                const Container& set = x.isBitset ? x : y;
+                for (uint16_t v : arr.values)
+                    if ((set.bits[v >> 6] >> (v & 63)) & 1) c.values.push_back(v);
+                c.cardinality = c.values.size();
+            } else {
+                set_intersection(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(),
+                                 back_inserter(c.values));
+                c.cardinality = c.values.size();
+            }
+            return c;
+        }
+
+        static uint64_t intersectCount(const Container& x, const Container& y) {
+            uint64_t count = 0;
+            if (x.isBitset && y.isBitset) {
+                for (int w = 0; w < BITSET_WORDS; ++w) count += __builtin_popcountll(x.bits[w] & y.bits[w]);
+            } else if (x.isBitset || y.isBitset) {
+                const Container& arr = x.isBitset ? y : x;
+                const Container& set = x.isBitset ? x : y;
+                for (uint16_t v : arr.values) count += (set.bits[v >> 6] >> (v & 63)) & 1;
+            } else {
+                size_t i = 0, j = 0;
+                while (i < x.values.size() && j < y.values.size()) {
+                    if (x.values[i] < y.values[j]) ++i;
+                    else if (y.values[j] < x.values[i]) ++j;
+                    else {
+                        ++count;
+                        ++i;
+                        ++j;
+                    }
+                }
+            }
+            return count;
+        }
+
+        static Container unite(const Container& x, const Container& y) {
+            Container c;
+            c.key = x.key;
+            if (!x.isBitset && !y.isBitset && x.cardinality + y.cardinality <= ARRAY_LIMIT) {
+                set_union(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(),
+                          back_inserter(c.values));
+                c.cardinality = c.values.size();
+                return c;
+            }
+            c.isBitset = true;
+            c.bits.assign(BITSET_WORDS, 0);
+            for (const Container* src : {&x, &y}) {
+                if (src->isBitset) for (int w = 0; w < BITSET_WORDS; ++w) c.bits[w] |= src->bits[w];
+                else for (uint16_t v : src->values) c.bits[v >> 6] |= 1ULL << (v & 63);
+            }
+            for (int w = 0; w < BITSET_WORDS; ++w) c.cardinality += __builtin_popcountll(c.bits[w]);
+            c.toArrayIfSparse();
+            return c;
+        }
+    };
+
+    vector<Container> containers;   // sorted by key
+
+    const Container* findContainer(uint16_t key) const {
+        auto it = lower_bound(containers.begin(), containers.end(), key,
+                              [](const Container& c, uint16_t k) { return c.key < k; });
+        return (it != containers.end() && it->key == key) ? &*it : nullptr;
+    }
+
+    Container& containerFor(uint16_t key) {
+        if (!containers.empty() && containers.back().key == key) return containers.back();
+        auto it = lower_bound(containers.begin(), containers.end(), key,
+                              [](const Container& c, uint16_t k) { return c.key < k; });
+        if (it != containers.end() && it->key == key) return *it;
+        Container c;
+        c.key = key;
+        return *containers.insert(it, move(c));
+    }
+};
+
+// One bitmap per distinct value of a low-cardinality column.
+class ColumnBitmapIndex {
+public:
+    void add(int value, uint32_t row) { bitmaps[value].add(row); }
+
+    const RoaringBitmap& rowsWith(int value) const {
+        static const RoaringBitmap none;
+        auto it = bitmaps.find(value);
+        return it == bitmaps.end() ? none : it->second;
+    }
+
+    size_t distinctValues() const { return bitmaps.size(); }
+
+private:
+    unordered_map<int, RoaringBitmap> bitmaps;
+};
+
+#endif // BITMAP_INDEX_HPP
@@ -0,0 +1,433 @@
+#ifndef BPLUS_TREE_HPP
+#define BPLUS_TREE_HPP
+
+#include <cstdint>
+#include <climits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+// ---------------- B+ Tree ----------------
+// Ordered map with all entries in the leaves and the leaves chained left
+// to right, so a range scan is one descent plus a walk along the chain.
+// Nodes hold up to ORDER keys; insert splits full nodes on the way back
+// up, erase borrows from or merges with a sibling when a node drops below
+// half. Insert, erase and lookups are O(log n); bulkLoad builds the tree
+// bottom-up from sorted input in O(n), leaving each node 3/4 full so the
+// first inserts do not all split.
+
+// Transactions ordered by date, ties by insertion sequence (unique).
+struct DateSeqKey {
+    int32_t date;       // YYYYMMDD
+    int32_t seq;
+
+    bool operator<(const DateSeqKey& other) const {
+        return date != other.date ? date < other.date : seq < other.seq;
+    }
+    bool operator==(const DateSeqKey& other) const { return date == other.date && seq == other.seq; }
+
+    static DateSeqKey first(int32_t date) { return {date, INT32_MIN}; }
+    static DateSeqKey last(int32_t date) { return {date, INT32_MAX}; }
+};
+
+template <typename Key, typename Value, int ORDER = 64>
+class BPlusTree {
+    static_assert(ORDER >= 4, "ORDER must be at least 4");
+    static constexpr int MIN_KEYS = ORDER / 2;
+
+    struct Node {
+        bool leaf;
+        int count = 0;
+        Key keys[ORDER + 1];            // one spare slot: insert first, then split
+        explicit Node(bool leaf) : leaf(leaf) {}
+    };
+
+    struct Leaf : Node {
+        Value values[ORDER + 1];
+        Leaf* next = nullptr;
+        Leaf* prev = nullptr;
+        Leaf() : Node(true) {}
+    };
+
+    // children[i] holds keys < keys[i] <= children[i + 1]
+    struct Inner : Node {
+        Node* children[ORDER + 2];
+        Inner() : Node(false) {}
+    };
+
+public:
+    class const_iterator {
+    public:
+        const_iterator(const Leaf* leaf = nullptr, int index = 0) : leaf(leaf), index(index) {}
+        const Key& key() const { return leaf->keys[index]; }
+        const Value& value() const { return leaf->values[index]; }
+        const_iterator& operator++() {
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const { return leaf == other.leaf && index == other.index; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const Leaf* leaf;
+        int index;
+    };
+
+    BPlusTree() = default;
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+    BPlusTree(BPlusTree&& other) noexcept { swap(other); }
+    BPlusTree& operator=(BPlusTree&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+    ~BPlusTree() { clear(); }
+
+    int size() const { return total; }
+    bool empty() const { return total == 0; }
+
+    int height() const {
+        int h = 0;
+        for (const Node* n = root; n; n = n->leaf ? nullptr : static_cast<const Inner*>(n)->children[0]) ++h;
+        return h;
+    }
+
+    void clear() {
+        destroy(root);
+        root = nullptr;
+        total = 0;
+    }
+
+    const_iterator begin() const {
+        const Node* n = root;
+        if (!n || total == 0) return end();
+        while (!n->leaf) n = static_cast<const Inner*>(n)->children[0];
+        return const_iterator(static_cast<const Leaf*>(n), 0);
+    }
+    const_iterator end() const { return const_iterator(); }
+
+    // First entry with key >= k.
+    const_iterator lowerBound(const Key& k) const {
+        if (!root) return end();
+        const Leaf* leaf = findLeaf(k);
+        int i = (int)(lower_bound(leaf->keys, leaf->keys + leaf->count, k) - leaf->keys);
+        if (i == leaf->count) {
+            leaf = leaf->next;
+            i = 0;
+        }
+        return leaf ? const_iterator(leaf, i) : end();
+    }
+
+    const Value* find(const Key& k) const {
+        const_iterator it = lowerBound(k);
+        return (it != end() && !(k < it.key())) ? &it.value() : nullptr;
+    }
+
+    // Calls fn(key, value) for every entry with from <= key <= to, in order.
+    template <typename Fn>
+    void scan(const Key& from, const Key& to, Fn fn) const {
+        for (const_iterator it = lowerBound(from); it != end() && !(to < it.key()); ++it) fn(it.key(), it.value());
+    }
+
+    // Inserts, or overwrites the value of an existing key.
+    void insert(const Key& k, const Value& v) {
+        if (!root) root = new Leaf;
+        Key separator;
+        Node* right = insertInto(root, k, v, separator);
+        if (right) {
+            Inner* top = new Inner;
+            top->count = 1;
+            top->keys[0] = separator;
+            top->children[0] = root;
+            top->children[1] = right;
+            root = top;
+        }
+    }
+
+    bool erase(const Key& k) {
+        if (!root || !eraseFrom(root, k)) return false;
+        if (!root->leaf && root->count == 0) {
+            Node* only = static_cast<Inner*>(root)->children[0];
+            delete static_cast<Inner*>(root);
+            root = only;
+        }
+        return true;
+    }
+
+    // Replaces the contents with `entries`, which must be sorted by key with
+    // no duplicates.
+    void bulkLoad(const vector<pair<Key, Value>>& entries) {
+        clear();
+        if (entries.empty()) return;
+        const int leafFill = max(MIN_KEYS, ORDER * 3 / 4);
+        const int innerFill = max(MIN_KEYS + 1, (ORDER + 1) * 3 / 4);
+
+        // Leaves: sizes spread evenly so none ends up nearly empty
+        vector<Node*> level;
+        vector<Key> lowKeys;
+        int n = (int)entries.size();
+        int leaves = (n + leafFill - 1) / leafFill;
+        Leaf* previous = nullptr;
+        for (int l = 0, pos = 0; l < leaves; ++l) {
+            int take = n / leaves + (l < n % leaves ? 1 : 0);
+            Leaf* leaf = new Leaf;
+            for (int i = 0; i < take; ++i, ++pos) {
+                leaf->keys[i] = entries[pos].first;
+                leaf->values[i] = entries[pos].second;
+            }
+            leaf->count = take;
+            leaf->prev = previous;
+            if (previous) previous->next = leaf;
+            previous = leaf;
+            level.push_back(leaf);
+            lowKeys.push_back(leaf->keys[0]);
+        }
+
+        // Inner levels until a single root remains
+        while (level.size() > 1) {
+            vector<Node*> parents;
+            vector<Key> parentLowKeys;
+            int m = (int)level.size();
+            int groups = (m + innerFill - 1) / innerFill;
+            for (int g = 0, pos = 0; g < groups; ++g) {
+                int take = m / groups + (g < m % groups ? 1 : 0);
+                Inner* inner = new Inner;
+                for (int i = 0; i < take; ++i, ++pos) {
+                    inner->children[i] = level[pos];
+                    if (i > 0) inner->keys[i - 1] = lowKeys[pos];
+                }
+                inner->count = take - 1;
+                parents.push_back(inner);
+                parentLowKeys.push_back(lowKeys[pos - take]);
+            }
+            level.swap(parents);
+            lowKeys.swap(parentLowKeys);
+        }
+        root = level[0];
+        total = n;
+    }
+
+private:
+    Node* root = nullptr;
+    int total = 0;
+
+    void swap(BPlusTree& other) {
+        std::swap(root, other.root);
+        std::swap(total, other.total);
+    }
+
+    static void destroy(Node* n) {
+        if (!n) return;
+        if (n->leaf) {
+            delete static_cast<Leaf*>(n);
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(n);
+        for (int i = 0; i <= inner->count; ++i) destroy(inner->children[i]);
+        delete inner;
+    }
+
+    static int childIndex(const Inner* inner, const Key& k) {
+        return (int)(upper_bound(inner->keys, inner->keys + inner->count, k) - inner->keys);
+    }
+
+    const Leaf* findLeaf(const Key& k) const {
+        const Node* n = root;
+        while (!n->leaf) {
+            const Inner* inner = static_cast<const Inner*>(n);
+            n = inner->children[childIndex(inner, k)];
+        }
+        return static_cast<const Leaf*>(n);
+    }
+
+    // Returns the new right sibling if `n` split (separator set to its
+    // lowest key), else nullptr.
+    Node* insertInto(Node* n, const Key& k, const Value& v, Key& separator) {
+        if (n->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(n);
+            int i = (int)(lower_bound(leaf->keys, leaf->keys + leaf->count, k) - leaf->keys);
+            if (i < leaf->count && !(k < leaf->keys[i])) {
+                leaf->values[i] = v;
+                return nullptr;
+            }
+            for (int j = leaf->count; j > i; --j) {
+                leaf->keys[j] = leaf->keys[j - 1];
+                leaf->values[j] = leaf->values[j - 1];
+            }
+            leaf->keys[i] = k;
+            leaf->values[i] = v;
+            leaf->count++;
+            total++;
+            if (leaf->count <= ORDER) return nullptr;
+
+            Leaf* right = new Leaf;
+            int keep = leaf->count / 2;
+            for (int j = keep; j < leaf->count; ++j) {
+                right->keys[j - keep] = leaf->keys[j];
+                right->values[j - keep] = leaf->values[j];
+            }
+            right->count = leaf->count - keep;
+            leaf->count = keep;
+            right->next = leaf->next;
+            if (right->next) right->next->prev = right;
+            right->prev = leaf;
+            leaf->next = right;
+            separator = right->keys[0];
+            return right;
+        }
+
+        Inner* inner = static_cast<Inner*>(n);
+        int i = childIndex(inner, k);
+        Key childSeparator;
+        Node* newChild = insertInto(inner->children[i], k, v, childSeparator);
+        if (!newChild) return nullptr;
+
+        for (int j = inner->count; j > i; --j) {
+            inner->keys[j] = inner->keys[j - 1];
+            inner->children[j + 1] = inner->children[j];
+        }
+        inner->keys[i] = childSeparator;
+        inner->children[i + 1] = newChild;
+        inner->count++;
+        if (inner->count <= ORDER) return nullptr;
+
+        // The middle key moves up; it is not kept in either half
+        Inner* right = new Inner;
+        int mid = inner->count / 2;
+        separator = inner->keys[mid];
+        for (int j = mid + 1; j < inner->count; ++j) right->keys[j - mid - 1] = inner->keys[j];
+        for (int j = mid + 1; j <= inner->count; ++j) right->children[j - mid - 1] = inner->children[j];
+        right->count = inner->count - mid - 1;
+        inner->count = mid;
+        return right;
+    }
+
+    bool eraseFrom(Node* n, const Key& k) {
+        if (n->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(n);
+            int i = (int)(lower_bound(leaf->keys, leaf->keys + leaf->count, k) - leaf->keys);
+            if (i == leaf->count || k < leaf->keys[i]) return false;
+            for (int j = i; j + 1 < leaf->count; ++j) {
+                leaf->keys[j] = leaf->keys[j + 1];
+                leaf->values[j] = leaf->values[j + 1];
+            }
+            leaf->count--;
+            total--;
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(n);
+        int i = childIndex(inner, k);
+        if (!eraseFrom(inner->children[i], k)) return false;
+        if (inner->children[i]->count < MIN_KEYS) rebalance(inner, i);
+        return true;
+    }
+
+    // children[i] of parent is below half: borrow from a sibling that can
+    // spare a key, otherwise merge with one and drop a separator.
+    void rebalance(Inner* parent, int i) {
+        Node* child = parent->children[i];
+        Node* left = i > 0 ? parent->children[i - 1] : nullptr;
+        Node* right = i < parent->count ? parent->children[i + 1] : nullptr;
+
+        if (child->leaf) {
+            Leaf* c = static_cast<Leaf*>(child);
+            Leaf* l = static_cast<Leaf*>(left);
+            Leaf* r = static_cast<Leaf*>(right);
+            if (l && l->count > MIN_KEYS) {
+                for (int j = c->count; j > 0; --j) {
+                    c->keys[j] = c->keys[j - 1];
+                    c->values[j] = c->values[j - 1];
+                }
+                c->keys[0] = l->keys[l->count - 1];
+                c->values[0] = l->values[l->count - 1];
+                c->count++;
+                l->count--;
+                parent->keys[i - 1] = c->keys[0];
+            } else if (r && r->count > MIN_KEYS) {
+                c->keys[c->count] = r->keys[0];
+                c->values[c->count] = r->values[0];
+                c->count++;
+                for (int j = 0; j + 1 < r->count; ++j) {
+                    r->keys[j] = r->keys[j + 1];
+                    r->values[j] = r->values[j + 1];
+                }
+                r->count--;
+                parent->keys[i] = r->keys[0];
+            } else if (l) {
+                mergeLeaves(l, c);
+                removeChild(parent, i - 1);
+            } else if (r) {
+                mergeLeaves(c, r);
+                removeChild(parent, i);
+            }
+            return;
+        }
+
+        Inner* c = static_cast<Inner*>(child);
+        Inner* l = static_cast<Inner*>(left);
+        Inner* r = static_cast<Inner*>(right);
+        if (l && l->count > MIN_KEYS) {
+            // Rotate right through the parent separator
+            for (int j = c->count; j > 0; --j) c->keys[j] = c->keys[j - 1];
+            for (int j = c->count + 1; j > 0; --j) c->children[j] = c->children[j - 1];
+            c->keys[0] = parent->keys[i - 1];
+            c->children[0] = l->children[l->count];
+            c->count++;
+            parent->keys[i - 1] = l->keys[l->count - 1];
+            l->count--;
+        } else if (r && r->count > MIN_KEYS) {
+            // Rotate left through the parent separator
+            c->keys[c->count] = parent->keys[i];
+            c->children[c->count + 1] = r->children[0];
+            c->count++;
+            parent->keys[i] = r->keys[0];
+            for (int j = 0; j + 1 < r->count; ++j) r->keys[j] = r->keys[j + 1];
+            for (int j = 0; j < r->count; ++j) r->children[j] = r->children[j + 1];
+            r->count--;
+        } else if (l) {
+            mergeInners(l, c, parent->keys[i - 1]);
+            removeChild(parent, i - 1);
+        } else if (r) {
+            mergeInners(c, r, parent->keys[i]);
+            removeChild(parent, i);
+        }
+    }
+
+    // Appends b to a and frees b.
+    static void mergeLeaves(Leaf* a, Leaf* b) {
+        for (int j = 0; j < b->count; ++j) {
+            a->keys[a->count + j] = b->keys[j];
+            a->values[a->count + j] = b->values[j];
+        }
+        a->count += b->count;
+        a->next = b->next;
+        if (a->next) a->next->prev = a;
+        delete b;
+    }
+
+    static void mergeInners(Inner* a, Inner* b, const Key& separator) {
+        a->keys[a->count] = separator;
+        for (int j = 0; j < b->count; ++j) a->keys[a->count + 1 + j] = b->keys[j];
+        for (int j = 0; j <= b->count; ++j) a->children[a->count + 1 + j] = b->children[j];
+        a->count += b->count + 1;
+        delete b;
+    }
+
+    // Drops keys[k] and children[k + 1] (the node merged into its left neighbour).
+    static void removeChild(Inner* parent, int k) {
+        for (int j = k; j + 1 < parent->count; ++j) parent->keys[j] = parent->keys[j + 1];
+        for (int j = k + 1; j < parent->count; ++j) parent->children[j] = parent->children[j + 1];
+        parent->count--;
+    }
+};
+
+#endif // BPLUS_TREE_HPP
@@ -0,0 +1,98 @@
+#ifndef BUCKET_SORT_HPP
+#define BUCKET_SORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// ---------------- Counting / Bucket Sort ----------------
+// O(n + range) sorts for integer keys with a small range (review length,
+// rating, ...). Keys are counted from the smallest one, so negative keys
+// are fine; when the range is much wider than n the sort falls back to a
+// comparison sort instead of allocating a counter per possible key. Ties
+// keep input order, or the reverse of it when reverseTies is set: that is
+// the order the recursive length merge produces, because it takes the
+// right-hand node on equal lengths.
+
+enum ReviewSortKey {
+    BY_REVIEW_LENGTH,
+    BY_RATING
+};
+
+// Works with Review and ReviewNode.
+template <typename R>
+int reviewSortKey(const R& r, ReviewSortKey key) {
+    return key == BY_RATING ? r.rating : (int)r.review.length();
+}
+
+// Final position of every item (out[slots[i]] = in[i] is one scatter).
+template <typename KeyFn>
+vector<int32_t> countingSortSlots(int n, KeyFn key, bool descending, bool reverseTies) {
+    vector<int32_t> keys(n);
+    vector<int32_t> slots(n);
+    if (n == 0) return slots;
+    int32_t minKey = key(0), maxKey = minKey;
+    for (int i = 0; i < n; ++i) {
+        keys[i] = key(i);
+        if (keys[i] < minKey) minKey = keys[i];
+        if (keys[i] > maxKey) maxKey = keys[i];
+    }
+
+    int64_t range = (int64_t)maxKey - minKey + 1;
+    if (range > (int64_t)n * 8 + 4096) {
+        // Sparse keys: same order from a comparison sort
+        vector<int32_t> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        sort(order.begin(), order.end(), [&](int32_t a, int32_t b) {
+            if (keys[a] != keys[b]) return descending ? keys[a] > keys[b] : keys[a] < keys[b];
+            return reverseTies ? a > b : a < b;
+        });
+        for (int p = 0; p < n; ++p) slots[order[p]] = p;
+        return slots;
+    }
+
+    // Starting slot of every key (offset by minKey), walking keys in output order
+    int buckets = (int)range;
+    vector<int32_t> next(buckets, 0);
+    for (int i = 0; i < n; ++i) next[keys[i] - minKey]++;
+    int position = 0;
+    for (int b = 0; b < buckets; ++b) {
+        int k = descending ? buckets - 1 - b : b;
+        int count = next[k];
+        next[k] = position;
+        position += count;
+    }
+
+    if (reverseTies) {
+        for (int i = n - 1; i >= 0; --i) slots[i] = next[keys[i] - minKey]++;
+    } else {
+        for (int i = 0; i < n; ++i) slots[i] = next[keys[i] - minKey]++;
+    }
+    return slots;
+}
+
+// Relinks a singly linked list by the slots above, so it gets the same key
+// range handling; `link` names the next-pointer member (TransactionNode::next,
+// ReviewNode::link).
+template <typename Node, typename KeyFn>
+Node* bucketSortList(Node* head, Node* Node::*link, KeyFn key, bool descending, bool reverseTies) {
+    vector<Node*> nodes;
+    vector<int32_t> keys;
+    for (Node* node = head; node; node = node->*link) {
+        nodes.push_back(node);
+        keys.push_back(key(*node));
+    }
+    if (nodes.empty()) return nullptr;
+
+    int n = (int)nodes.size();
+    vector<int32_t> slots = countingSortSlots(n, [&](int i) { return keys[i]; }, descending, reverseTies);
+    vector<Node*> sorted(n);
+    for (int i = 0; i < n; ++i) sorted[slots[i]] = nodes[i];
+    for (int i = 0; i + 1 < n; ++i) sorted[i]->*link = sorted[i + 1];
+    sorted[n - 1]->*link = nullptr;
+    return sorted[0];
+}
+
+#endif // BUCKET_SORT_HPP
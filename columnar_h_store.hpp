@@ -0,0 +1,758 @@
+#ifndef COLUMNAR_STORE_HPP
+#define COLUMNAR_STORE_HPP
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include "packed_h_record.hpp"
+#include "stats_h_sketches.hpp"
+
+using namespace std;
+
+// ---------------- Columnar File Format ----------------
+// Transactions or reviews stored column by column in row groups:
+//
+//   "DSCOL1\n\0" | u32 schema | row group 0 | row group 1 | ... |
+//   footer: u32 groups, per group RowGroupInfo | u64 footer offset | "DSCOLEND"
+//
+// Every column starts with an encoding tag:
+//   dates        delta + zigzag varint (YYYYMMDD ints)
+//   category,
+//   payment      dictionary + run-length
+//   price        scaled integers (cents), frame-of-reference bit-packed;
+//                raw doubles if a value is not exact at 1/100 or 1/10000
+//   rating       frame-of-reference bit-packed
+//   text         length-prefixed strings, LZ-compressed as one block
+//
+// The footer keeps min/max and two 256-bit Bloom filters per row group, so
+// a reader skips every group that cannot match the predicate and only
+// seeks to the rest. Decoded rows are filtered exactly afterwards.
+
+namespace columnar_detail {
+
+enum ColumnEncoding : uint8_t {
+    DELTA_VARINT = 1,
+    DICT_RLE = 2,
+    FOR_SCALED = 3,
+    RAW_DOUBLE = 4,
+    LZ_TEXT = 5,
+    FOR_INT = 6,
+    PLAIN_TEXT_DATES = 7
+};
+
+class ByteWriter {
+public:
+    string bytes;
+
+    template <typename T>
+    void put(T value) { bytes.append((const char*)&value, sizeof(T)); }
+
+    void putVarint(uint64_t v) {
+        while (v >= 0x80) {
+            bytes.push_back((char)(v | 0x80));
+            v >>= 7;
+        }
+        bytes.push_back((char)v);
+    }
+
+    void putSigned(int64_t v) { putVarint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }    // zigzag
+
+    void putString(string_view s) {
+        putVarint(s.size());
+        bytes.append(s.data(), s.size());
+    }
+
+    void putBlock(const string& block) {
+        putVarint(block.size());
+        bytes += block;
+    }
+};
+
+class ByteReader {
+public:
+    explicit ByteReader(string_view in) : in(in) {}
+
+    bool ok() const { return good; }
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (pos + sizeof(T) > in.size()) {
+            good = false;
+            return value;
+        }
+        memcpy(&value, in.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    uint64_t getVarint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= in.size()) {
+                good = false;
+                return 0;
+            }
+            uint8_t b = (uint8_t)in[pos++];
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        good = false;
+        return 0;
+    }
+
+    int64_t getSigned() {
+        uint64_t v = getVarint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+
+    string_view getString() {
+        uint64_t size = getVarint();
+        if (!good || pos + size > in.size()) {
+            good = false;
+            return string_view();
+        }
+        string_view s = in.substr(pos, size);
+        pos += size;
+        return s;
+    }
+
+private:
+    string_view in;
+    size_t pos = 0;
+    bool good = true;
+};
+
+// ---- LZ77 block compression (LZ4-style sequences) ----
+// token: high nibble literal length, low nibble match length - 4 (15 means
+// more length bytes follow, 255 = continue); then literals, then a 16-bit
+// little-endian offset. The final sequence carries literals only.
+
+inline void putLength(string& out, size_t extra) {
+    while (extra >= 255) {
+        out.push_back((char)255);
+        extra -= 255;
+    }
+    out.push_back((char)extra);
+}
+
+inline string lzCompress(string_view in) {
+    const int HASH_BITS = 14;
+    const size_t MIN_MATCH = 4, MAX_OFFSET = 65535;
+    vector<int32_t> table((size_t)1 << HASH_BITS, -1);
+    auto read32 = [&](size_t i) {
+        uint32_t v;
+        memcpy(&v, in.data() + i, 4);
+        return v;
+    };
+    auto hashAt = [&](size_t i) { return (read32(i) * 2654435761u) >> (32 - HASH_BITS); };
+
+    string out;
+    out.reserve(in.size() / 2 + 16);
+    size_t anchor = 0, i = 0;
+    auto emit = [&](size_t literalEnd, size_t matchLength, size_t offset) {
+        size_t literals = literalEnd - anchor;
+        uint8_t token = (uint8_t)(min<size_t>(literals, 15) << 4);
+        if (matchLength) token |= (uint8_t)min<size_t>(matchLength - MIN_MATCH, 15);
+        out.push_back((char)token);
+        if (literals >= 15) putLength(out, literals - 15);
+        out.append(in.data() + anchor, literals);
+        if (matchLength) {
+            out.push_back((char)(offset & 0xFF));
+            out.push_back((char)(offset >> 8));
+            if (matchLength - MIN_MATCH >= 15) putLength(out, matchLength - MIN_MATCH - 15);
+        }
+    };
+
+    while (i + MIN_MATCH <= in.size()) {
+        uint32_t h = hashAt(i);
+        int32_t candidate = table[h];
+        table[h] = (int32_t)i;
+        if (candidate >= 0 && i - candidate <= MAX_OFFSET && read32(candidate) == read32(i)) {
+            size_t length = MIN_MATCH;
+            while (i + length < in.size() && in[candidate + length] == in[i + length]) ++length;
+            emit(i, length, i - candidate);
+            i += length;
+            anchor = i;
+        } else {
+            ++i;
+        }
+    }
+    emit(in.size(), 0, 0);
+    return out;
+}
+
+inline bool lzDecompress(string_view in, size_t rawSize, string& out) {
+    out.clear();
+    out.reserve(min(rawSize, in.size() * 8));     // rawSize comes from the file
+    size_t p = 0;
+    auto readLength = [&](size_t base) -> size_t {
+        size_t length = base;
+        if (base != 15) return length;
+        while (p < in.size()) {
+            uint8_t b = (uint8_t)in[p++];
+            length += b;
+            if (b != 255) break;
+        }
+        return length;
+    };
+    while (p < in.size()) {
+        uint8_t token = (uint8_t)in[p++];
+        size_t literals = readLength(token >> 4);
+        if (p + literals > in.size()) return false;
+        out.append(in.data() + p, literals);
+        p += literals;
+        if (p >= in.size()) break;      // last sequence: literals only
+        if (p + 2 > in.size()) return false;
+        size_t offset = (uint8_t)in[p] | ((size_t)(uint8_t)in[p + 1] << 8);
+        p += 2;
+        size_t length = readLength(token & 0x0F) + 4;
+        if (offset == 0 || offset > out.size()) return false;
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < length; ++k) out.push_back(out[from + k]);     // may overlap
+    }
+    return out.size() == rawSize;
+}
+
+// ---- Column encoders ----
+
+inline void encodeDates(ByteWriter& w, const vector<int32_t>& dates) {
+    w.put<uint8_t>(DELTA_VARINT);
+    int32_t previous = 0;
+    for (int32_t d : dates) {
+        w.putSigned((int64_t)d - previous);
+        previous = d;
+    }
+}
+
+inline void encodeDictionary(ByteWriter& w, const vector<string_view>& values) {
+    w.put<uint8_t>(DICT_RLE);
+    unordered_map<string_view, uint32_t> ids;
+    vector<string_view> dictionary;
+    vector<uint32_t> codes;
+    codes.reserve(values.size());
+    for (string_view v : values) {
+        auto it = ids.find(v);
+        if (it == ids.end()) {
+            it = ids.emplace(v, (uint32_t)dictionary.size()).first;
+            dictionary.push_back(v);
+        }
+        codes.push_back(it->second);
+    }
+    w.putVarint(dictionary.size());
+    for (string_view s : dictionary) w.putString(s);
+    for (size_t i = 0; i < codes.size();) {
+        size_t run = 1;
+        while (i + run < codes.size() && codes[i + run] == codes[i]) ++run;
+        w.putVarint(codes[i]);
+        w.putVarint(run);
+        i += run;
+    }
+}
+
+// Values are offset from their minimum and packed at the smallest width.
+inline void packFrameOfReference(ByteWriter& w, const vector<int64_t>& values) {
+    int64_t lo = values.empty() ? 0 : *min_element(values.begin(), values.end());
+    uint64_t range = 0;
+    for (int64_t v : values) range = max(range, (uint64_t)(v - lo));
+    int width = 0;
+    while (width < 64 && (range >> width) != 0) ++width;
+
+    w.putSigned(lo);
+    w.put<uint8_t>((uint8_t)width);
+    uint64_t buffer = 0;
+    int filled = 0;
+    for (int64_t v : values) {
+        uint64_t x = (uint64_t)(v - lo);
+        for (int bit = 0; bit < width; ++bit) {
+            buffer |= ((x >> bit) & 1) << filled;
+            if (++filled == 8) {
+                w.put<uint8_t>((uint8_t)buffer);
+                buffer = 0;
+                filled = 0;
+            }
+        }
+    }
+    if (filled) w.put<uint8_t>((uint8_t)buffer);
+}
+
+inline void encodePrices(ByteWriter& w, const vector<double>& prices) {
+    for (int64_t scale : {100LL, 10000LL}) {
+        vector<int64_t> scaled;
+        scaled.reserve(prices.size());
+        bool exact = true;
+        for (double p : prices) {
+            if (!(fabs(p) < 1e12)) {
+                exact = false;
+                break;
+            }
+            int64_t s = llround(p * scale);
+            if ((double)s / scale != p) {
+                exact = false;
+                break;
+            }
+            scaled.push_back(s);
+        }
+        if (!exact) continue;
+        w.put<uint8_t>(FOR_SCALED);
+        w.putVarint(scale);
+        packFrameOfReference(w, scaled);
+        return;
+    }
+    w.put<uint8_t>(RAW_DOUBLE);
+    for (double p : prices) w.put(p);
+}
+
+inline void encodeSmallInts(ByteWriter& w, const vector<int32_t>& values) {
+    w.put<uint8_t>(FOR_INT);
+    packFrameOfReference(w, vector<int64_t>(values.begin(), values.end()));
+}
+
+inline void encodeText(ByteWriter& w, const vector<string_view>& values) {
+    ByteWriter raw;
+    for (string_view s : values) raw.putString(s);
+    w.put<uint8_t>(LZ_TEXT);
+    w.putVarint(raw.bytes.size());
+    w.putBlock(lzCompress(raw.bytes));
+}
+
+// ---- Column decoders (count rows each; false on malformed input) ----
+
+inline bool decodeFrameOfReference(ByteReader& r, size_t count, vector<int64_t>& out) {
+    int64_t lo = r.getSigned();
+    int width = r.get<uint8_t>();
+    if (!r.ok() || width > 64) return false;
+    out.assign(count, lo);
+    uint8_t byte = 0;
+    int available = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t x = 0;
+        for (int bit = 0; bit < width; ++bit) {
+            if (available == 0) {
+                byte = r.get<uint8_t>();
+                available = 8;
+            }
+            x |= (uint64_t)(byte & 1) << bit;
+            byte >>= 1;
+            --available;
+        }
+        out[i] = lo + (int64_t)x;
+    }
+    return r.ok();
+}
+
+inline bool decodeDates(ByteReader& r, size_t count, vector<int32_t>& out) {
+    if (r.get<uint8_t>() != DELTA_VARINT) return false;
+    out.resize(count);
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; ++i) {
+        previous += r.getSigned();
+        out[i] = (int32_t)previous;
+    }
+    return r.ok();
+}
+
+inline bool decodeDictionary(ByteReader& r, size_t count, vector<string_view>& out) {
+    if (r.get<uint8_t>() != DICT_RLE) return false;
+    uint64_t entries = r.getVarint();
+    if (entries > count) return false;
+    vector<string_view> dictionary(entries);
+    for (auto& s : dictionary) s = r.getString();
+    out.clear();
+    out.reserve(count);
+    while (r.ok() && out.size() < count) {
+        uint64_t code = r.getVarint();
+        uint64_t run = r.getVarint();
+        if (code >= dictionary.size() || out.size() + run > count) return false;
+        out.insert(out.end(), run, dictionary[code]);
+    }
+    return r.ok() && out.size() == count;
+}
+
+inline bool decodePrices(ByteReader& r, size_t count, vector<double>& out) {
+    uint8_t encoding = r.get<uint8_t>();
+    out.resize(count);
+    if (encoding == RAW_DOUBLE) {
+        for (auto& p : out) p = r.get<double>();
+        return r.ok();
+    }
+    if (encoding != FOR_SCALED) return false;
+    int64_t scale = (int64_t)r.getVarint();
+    vector<int64_t> scaled;
+    if (scale <= 0 || !decodeFrameOfReference(r, count, scaled)) return false;
+    for (size_t i = 0; i < count; ++i) out[i] = (double)scaled[i] / scale;
+    return true;
+}
+
+inline bool decodeSmallInts(ByteReader& r, size_t count, vector<int32_t>& out) {
+    if (r.get<uint8_t>() != FOR_INT) return false;
+    vector<int64_t> values;
+    if (!decodeFrameOfReference(r, count, values)) return false;
+    out.assign(values.begin(), values.end());
+    return true;
+}
+
+// `storage` owns the decompressed bytes the views point into.
+inline bool decodeText(ByteReader& r, size_t count, string& storage, vector<string_view>& out) {
+    if (r.get<uint8_t>() != LZ_TEXT) return false;
+    uint64_t rawSize = r.getVarint();
+    string_view block = r.getString();
+    if (!r.ok() || !lzDecompress(block, rawSize, storage)) return false;
+    ByteReader text(storage);
+    out.resize(count);
+    for (auto& s : out) s = text.getString();
+    return text.ok();
+}
+
+// ---- Row group statistics ----
+
+struct Bloom256 {
+    uint64_t bits[4] = {0, 0, 0, 0};
+
+    void add(string_view s) {
+        uint64_t h = stableHash64(s);
+        for (int k = 0; k < 3; ++k) {
+            uint32_t bit = (uint32_t)((h >> (k * 16)) & 0xFF);
+            bits[bit >> 6] |= 1ULL << (bit & 63);
+        }
+    }
+
+    bool mayContain(string_view s) const {
+        uint64_t h = stableHash64(s);
+        for (int k = 0; k < 3; ++k) {
+            uint32_t bit = (uint32_t)((h >> (k * 16)) & 0xFF);
+            if (!(bits[bit >> 6] & (1ULL << (bit & 63)))) return false;
+        }
+        return true;
+    }
+};
+
+// Transactions: key = date, value = price, blooms = category / payment.
+// Reviews:      key = rating,               blooms = product / customer.
+struct RowGroupInfo {
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    uint32_t rows = 0;
+    int32_t minKey = 0, maxKey = 0;
+    double minValue = 0, maxValue = 0;
+    Bloom256 bloomA, bloomB;
+};
+
+const char FILE_MAGIC[8] = {'D', 'S', 'C', 'O', 'L', '1', '\n', '\0'};
+const char END_MAGIC[8] = {'D', 'S', 'C', 'O', 'L', 'E', 'N', 'D'};
+
+inline void writeInfo(ByteWriter& w, const RowGroupInfo& g) {
+    w.put(g.offset);
+    w.put(g.size);
+    w.put(g.rows);
+    w.put(g.minKey);
+    w.put(g.maxKey);
+    w.put(g.minValue);
+    w.put(g.maxValue);
+    for (uint64_t b : g.bloomA.bits) w.put(b);
+    for (uint64_t b : g.bloomB.bits) w.put(b);
+}
+
+inline RowGroupInfo readInfo(ByteReader& r) {
+    RowGroupInfo g;
+    g.offset = r.get<uint64_t>();
+    g.size = r.get<uint32_t>();
+    g.rows = r.get<uint32_t>();
+    g.minKey = r.get<int32_t>();
+    g.maxKey = r.get<int32_t>();
+    g.minValue = r.get<double>();
+    g.maxValue = r.get<double>();
+    for (auto& b : g.bloomA.bits) b = r.get<uint64_t>();
+    for (auto& b : g.bloomB.bits) b = r.get<uint64_t>();
+    return g;
+}
+
+// Writes header, the groups produced by encodeGroup(begin, end, info) and the footer.
+template <typename EncodeGroup>
+bool writeColumnarFile(const string& filename, uint32_t schema, int count, int rowGroupRows, EncodeGroup encodeGroup) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    if (rowGroupRows < 1) rowGroupRows = 65536;
+
+    file.write(FILE_MAGIC, 8);
+    file.write((const char*)&schema, 4);
+    uint64_t offset = 12;
+
+    vector<RowGroupInfo> groups;
+    for (int begin = 0; begin < count; begin += rowGroupRows) {
+        int end = min(count, begin + rowGroupRows);
+        RowGroupInfo info;
+        ByteWriter w;
+        encodeGroup(begin, end, w, info);
+        info.offset = offset;
+        info.size = (uint32_t)w.bytes.size();
+        info.rows = (uint32_t)(end - begin);
+        file.write(w.bytes.data(), w.bytes.size());
+        offset += w.bytes.size();
+        groups.push_back(info);
+    }
+
+    ByteWriter footer;
+    footer.put<uint32_t>((uint32_t)groups.size());
+    for (const auto& g : groups) writeInfo(footer, g);
+    footer.put<uint64_t>(offset);
+    footer.bytes.append(END_MAGIC, 8);
+    file.write(footer.bytes.data(), footer.bytes.size());
+    return (bool)file;
+}
+
+// Reads the footer, then hands every group that passes `keep` to decodeGroup.
+template <typename Keep, typename DecodeGroup>
+bool readColumnarFile(const string& filename, uint32_t schema, Keep keep, DecodeGroup decodeGroup,
+                      int* groupCount, int* groupsRead) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[8];
+    uint32_t fileSchema = 0;
+    file.read(magic, 8);
+    file.read((char*)&fileSchema, 4);
+    if (!file || memcmp(magic, FILE_MAGIC, 8) != 0 || fileSchema != schema) return false;
+
+    file.seekg(0, ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    if (fileSize < 12 + 4 + 16) return false;
+    char tail[16];
+    file.seekg(fileSize - 16);
+    file.read(tail, 16);
+    uint64_t footerOffset;
+    memcpy(&footerOffset, tail, 8);
+    if (memcmp(tail + 8, END_MAGIC, 8) != 0 || footerOffset > fileSize - 16) return false;
+
+    string footerBytes(fileSize - 16 - footerOffset, '\0');
+    file.seekg(footerOffset);
+    file.read(&footerBytes[0], footerBytes.size());
+    ByteReader footer(footerBytes);
+    uint32_t groups = footer.get<uint32_t>();
+    vector<RowGroupInfo> infos;
+    for (uint32_t i = 0; i < groups && footer.ok(); ++i) infos.push_back(readInfo(footer));
+    if (!footer.ok()) return false;
+
+    if (groupCount) *groupCount = (int)infos.size();
+    if (groupsRead) *groupsRead = 0;
+    string bytes;
+    for (const auto& info : infos) {
+        if (!keep(info)) continue;
+        if (info.offset + info.size > footerOffset) return false;
+        bytes.resize(info.size);
+        file.seekg(info.offset);
+        file.read(&bytes[0], info.size);
+        if (!file) return false;
+        ByteReader r(bytes);
+        if (!decodeGroup(r, info)) return false;
+        if (groupsRead) ++*groupsRead;
+    }
+    return true;
+}
+
+} // namespace columnar_detail
+
+enum ColumnarSchema : uint32_t {
+    COLUMNAR_TRANSACTIONS = 1,
+    COLUMNAR_REVIEWS = 2
+};
+
+// True if the file starts with the columnar magic (loaders use this to
+// choose between CSV and columnar input).
+inline bool isColumnarFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[8];
+    return file.read(magic, 8) && memcmp(magic, columnar_detail::FILE_MAGIC, 8) == 0;
+}
+
+// Empty strings / full ranges mean "no condition". The default ranges span
+// every int, so loading without a predicate keeps rows whose date or rating
+// is out of the usual range, exactly as the CSV readers do.
+struct TransactionPredicate {
+    int fromDate = INT_MIN;         // YYYYMMDD, inclusive
+    int toDate = INT_MAX;
+    string category;
+    string paymentMethod;
+};
+
+struct ReviewPredicate {
+    int minRating = INT_MIN;        // inclusive
+    int maxRating = INT_MAX;
+    string product;
+    string customer;
+};
+
+struct ColumnarScanInfo {
+    int rowGroups = 0;
+    int rowGroupsRead = 0;
+};
+
+// row(i) returns the i-th Record (either backend).
+template <typename GetRow>
+bool writeTransactionsColumnar(const string& filename, int count, GetRow row, int rowGroupRows = 65536) {
+    using namespace columnar_detail;
+    return writeColumnarFile(filename, COLUMNAR_TRANSACTIONS, count, rowGroupRows,
+                             [&](int begin, int end, ByteWriter& w, RowGroupInfo& info) {
+        vector<string_view> customers, products, categories, payments, dateText;
+        vector<int32_t> dates;
+        vector<double> prices;
+        bool canonicalDates = true;
+        for (int i = begin; i < end; ++i) {
+            const auto& r = row(i);
+            customers.push_back(r.customerID);
+            products.push_back(r.product);
+            categories.push_back(r.category);
+            payments.push_back(r.paymentMethod);
+            dateText.push_back(r.date);
+            dates.push_back(r.dateToInt());
+            prices.push_back(r.price);
+            canonicalDates = canonicalDates && packedDateToString(dates.back()) == r.date;
+            info.bloomA.add(r.category);
+            info.bloomB.add(r.paymentMethod);
+        }
+        info.minKey = *min_element(dates.begin(), dates.end());
+        info.maxKey = *max_element(dates.begin(), dates.end());
+        info.minValue = *min_element(prices.begin(), prices.end());
+        info.maxValue = *max_element(prices.begin(), prices.end());
+
+        encodeText(w, customers);
+        encodeText(w, products);
+        encodeDictionary(w, categories);
+        encodePrices(w, prices);
+        // Dates that would not print back identically keep their text too
+        if (canonicalDates) {
+            encodeDates(w, dates);
+        } else {
+            w.put<uint8_t>(PLAIN_TEXT_DATES);
+            encodeDates(w, dates);
+            encodeText(w, dateText);
+        }
+        encodeDictionary(w, payments);
+    });
+}
+
+// Appends the matching rows to `out` as R (either backend's Record; its
+// text fields intern what they are assigned).
+template <typename R>
+bool readTransactionsColumnar(const string& filename, vector<R>& out,
+                              const TransactionPredicate& pred = TransactionPredicate(),
+                              ColumnarScanInfo* scan = nullptr) {
+    using namespace columnar_detail;
+    auto keep = [&](const RowGroupInfo& g) {
+        if (g.maxKey < pred.fromDate || g.minKey > pred.toDate) return false;
+        if (!pred.category.empty() && !g.bloomA.mayContain(pred.category)) return false;
+        if (!pred.paymentMethod.empty() && !g.bloomB.mayContain(pred.paymentMethod)) return false;
+        return true;
+    };
+    auto decode = [&](ByteReader& r, const RowGroupInfo& g) {
+        size_t n = g.rows;
+        string customerText, productText, dateStorage;
+        vector<string_view> customers, products, categories, payments, dateText;
+        vector<int32_t> dates;
+        vector<double> prices;
+        if (!decodeText(r, n, customerText, customers) || !decodeText(r, n, productText, products) ||
+            !decodeDictionary(r, n, categories) || !decodePrices(r, n, prices))
+            return false;
+        bool plainDates = false;
+        {
+            ByteReader peek = r;
+            plainDates = peek.get<uint8_t>() == PLAIN_TEXT_DATES;
+            if (plainDates) r = peek;
+        }
+        if (!decodeDates(r, n, dates)) return false;
+        if (plainDates && !decodeText(r, n, dateStorage, dateText)) return false;
+        if (!decodeDictionary(r, n, payments)) return false;
+
+        for (size_t i = 0; i < n; ++i) {
+            if (dates[i] < pred.fromDate || dates[i] > pred.toDate) continue;
+            if (!pred.category.empty() && categories[i] != pred.category) continue;
+            if (!pred.paymentMethod.empty() && payments[i] != pred.paymentMethod) continue;
+            R rec;
+            rec.customerID = customers[i];
+            rec.product = products[i];
+            rec.category = categories[i];
+            rec.price = prices[i];
+            rec.date = plainDates ? string(dateText[i]) : packedDateToString(dates[i]);
+            rec.paymentMethod = payments[i];
+            out.push_back(move(rec));
+        }
+        return true;
+    };
+    return readColumnarFile(filename, COLUMNAR_TRANSACTIONS, keep, decode,
+                            scan ? &scan->rowGroups : nullptr, scan ? &scan->rowGroupsRead : nullptr);
+}
+
+// row(i) returns the i-th Review / ReviewNode.
+template <typename GetRow>
+bool writeReviewsColumnar(const string& filename, int count, GetRow row, int rowGroupRows = 65536) {
+    using namespace columnar_detail;
+    return writeColumnarFile(filename, COLUMNAR_REVIEWS, count, rowGroupRows,
+                             [&](int begin, int end, ByteWriter& w, RowGroupInfo& info) {
+        vector<string_view> products, customers, texts;
+        vector<int32_t> ratings;
+        for (int i = begin; i < end; ++i) {
+            const auto& r = row(i);
+            products.push_back(r.product_id);
+            customers.push_back(r.customer_id);
+            ratings.push_back(r.rating);
+            texts.push_back(r.review);
+            info.bloomA.add(r.product_id);
+            info.bloomB.add(r.customer_id);
+        }
+        info.minKey = *min_element(ratings.begin(), ratings.end());
+        info.maxKey = *max_element(ratings.begin(), ratings.end());
+
+        encodeText(w, products);
+        encodeText(w, customers);
+        encodeSmallInts(w, ratings);
+        encodeText(w, texts);
+    });
+}
+
+// Appends the matching rows to `out` (R needs product_id, customer_id,
+// rating and review).
+template <typename R>
+bool readReviewsColumnar(const string& filename, vector<R>& out,
+                         const ReviewPredicate& pred = ReviewPredicate(),
+                         ColumnarScanInfo* scan = nullptr) {
+    using namespace columnar_detail;
+    auto keep = [&](const RowGroupInfo& g) {
+        if (g.maxKey < pred.minRating || g.minKey > pred.maxRating) return false;
+        if (!pred.product.empty() && !g.bloomA.mayContain(pred.product)) return false;
+        if (!pred.customer.empty() && !g.bloomB.mayContain(pred.customer)) return false;
+        return true;
+    };
+    auto decode = [&](ByteReader& r, const RowGroupInfo& g) {
+        size_t n = g.rows;
+        string productText, customerText, reviewText;
+        vector<string_view> products, customers, texts;
+        vector<int32_t> ratings;
+        if (!decodeText(r, n, productText, products) || !decodeText(r, n, customerText, customers) ||
+            !decodeSmallInts(r, n, ratings) || !decodeText(r, n, reviewText, texts))
+            return false;
+
+        for (size_t i = 0; i < n; ++i) {
+            if (ratings[i] < pred.minRating || ratings[i] > pred.maxRating) continue;
+            if (!pred.product.empty() && products[i] != pred.product) continue;
+            if (!pred.customer.empty() && customers[i] != pred.customer) continue;
+            R rec;
+            rec.product_id = products[i];
+            rec.customer_id = customers[i];
+            rec.rating = ratings[i];
+            rec.review = string(texts[i]);
+            out.push_back(move(rec));
+        }
+        return true;
+    };
+    return readColumnarFile(filename, COLUMNAR_REVIEWS, keep, decode,
+                            scan ? &scan->rowGroups : nullptr, scan ? &scan->rowGroupsRead : nullptr);
+}
+
+#endif // COLUMNAR_STORE_HPP
@@ -0,0 +1,431 @@
+#ifndef CSV_READER_HPP
+#define CSV_READER_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+// ---------------- Double-Buffered File Reader ----------------
+// A background thread reads the next block of the file while the caller
+// parses the lines of the previous one. Lines that straddle two blocks are
+// stitched together in a small carry string.
+
+class AsyncLineReader {
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;   // 1 MiB per buffer
+    static const size_t ALIGNMENT = 4096;
+
+    explicit AsyncLineReader(const string& filename, size_t bufferSize = BUFFER_SIZE)
+        : file(fopen(filename.c_str(), "rb")), capacity(bufferSize) {
+        if (!file) return;
+        for (int i = 0; i < 2; ++i) {
+            storage[i].resize(capacity + ALIGNMENT);
+            uintptr_t raw = reinterpret_cast<uintptr_t>(storage[i].data());
+            buffers[i] = reinterpret_cast<char*>((raw + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1));
+        }
+        worker = thread(&AsyncLineReader::readLoop, this);
+    }
+
+    ~AsyncLineReader() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+        if (file) fclose(file);
+    }
+
+    AsyncLineReader(const AsyncLineReader&) = delete;
+    AsyncLineReader& operator=(const AsyncLineReader&) = delete;
+
+    bool is_open() const { return file != nullptr; }
+
+    // Returns the next line without its trailing "\n" / "\r\n". The view stays
+    // valid until the next call.
+    bool nextLine(string_view& line) {
+        if (!file) return false;
+        carry.clear();
+
+        while (true) {
+            if (!acquired && !acquire()) {
+                if (carry.empty()) return false;
+                line = trimCR(string_view(carry));
+                return true;
+            }
+
+            const char* begin = buffers[current] + pos;
+            size_t remaining = filled[current] - pos;
+            const char* nl = static_cast<const char*>(memchr(begin, '\n', remaining));
+
+            if (nl) {
+                size_t len = nl - begin;
+                pos += len + 1;
+                if (carry.empty()) {
+                    line = trimCR(string_view(begin, len));
+                } else {
+                    carry.append(begin, len);
+                    line = trimCR(string_view(carry));
+                }
+                return true;
+            }
+
+            // Line continues in the next buffer.
+            carry.append(begin, remaining);
+            release();
+        }
+    }
+
+    // Like nextLine, but keeps reading while a quoted field is still open,
+    // so a record may span several physical lines (RFC 4180).
+    // Quote parity is carried across lines, so each line is scanned once.
+    bool nextRecord(string_view& record) {
+        if (!nextLine(record)) return false;
+        if (!hasOpenQuote(record)) return true;
+
+        recordBuf.assign(record.data(), record.size());
+        bool open = true;
+        string_view more;
+        while (open && nextLine(more)) {
+            recordBuf += '\n';
+            recordBuf.append(more.data(), more.size());
+            open ^= hasOpenQuote(more);
+        }
+        record = recordBuf;
+        return true;
+    }
+
+private:
+    FILE* file;
+    size_t capacity;
+    vector<char> storage[2];
+    char* buffers[2] = {nullptr, nullptr};
+    size_t filled[2] = {0, 0};
+    bool ready[2] = {false, false};
+    bool stopping = false;
+
+    mutex mtx;
+    condition_variable cv;
+    thread worker;
+
+    int current = 0;
+    size_t pos = 0;
+    bool acquired = false;
+    bool finished = false;
+    string carry;
+    string recordBuf;
+
+    static bool hasOpenQuote(string_view s) {
+        size_t quotes = 0;
+        for (char c : s) quotes += (c == '"');
+        return quotes & 1;
+    }
+
+    static string_view trimCR(string_view s) {
+        if (!s.empty() && s.back() == '\r') s.remove_suffix(1);
+        return s;
+    }
+
+    // Reader thread: fill buffers alternately, waiting until the parser has
+    // handed each one back.
+    void readLoop() {
+        int next = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(mtx);
+                cv.wait(lock, [&] { return stopping || !ready[next]; });
+                if (stopping) return;
+            }
+            size_t n = fread(buffers[next], 1, capacity, file);
+            {
+                lock_guard<mutex> lock(mtx);
+                filled[next] = n;
+                ready[next] = true;
+            }
+            cv.notify_all();
+            if (n == 0) return;   // EOF is signalled by an empty buffer
+            next ^= 1;
+        }
+    }
+
+    bool acquire() {
+        if (finished) return false;
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [&] { return ready[current]; });
+        if (filled[current] == 0) {
+            finished = true;
+            return false;
+        }
+        pos = 0;
+        acquired = true;
+        return true;
+    }
+
+    void release() {
+        {
+            lock_guard<mutex> lock(mtx);
+            ready[current] = false;
+        }
+        cv.notify_all();
+        acquired = false;
+        current ^= 1;
+    }
+};
+
+// ---------------- Field Helpers ----------------
+
+// RFC 4180 field parser. Unquoted fields are cut with memchr; quoted fields
+// are copied segment by segment between quote characters, with "" becoming
+// a literal quote. Returns the number of fields stored in `fields`.
+// When maxFields is reached, an unquoted last field keeps the rest of the
+// row, commas included, so hand-edited rows still load.
+inline int parseCSVRecord(string_view row, string* fields, int maxFields) {
+    const char* p = row.data();
+    const char* end = p + row.size();
+    int count = 0;
+
+    while (count < maxFields) {
+        string& field = fields[count++];
+        field.clear();
+        bool last = (count == maxFields);
+
+        if (p < end && *p == '"') {
+            ++p;
+            while (p < end) {
+                const char* q = static_cast<const char*>(memchr(p, '"', end - p));
+                if (!q) {               // unterminated quote: take the rest
+                    field.append(p, end - p);
+                    p = end;
+                    break;
+                }
+                field.append(p, q - p);
+                p = q + 1;
+                if (p < end && *p == '"') {
+                    field += '"';       // escaped quote
+                    ++p;
+                } else {
+                    break;              // closing quote
+                }
+            }
+            // Tolerate stray characters between the closing quote and the comma
+            const char* comma = static_cast<const char*>(memchr(p, ',', end - p));
+            const char* stop = comma ? comma : end;
+            field.append(p, stop - p);
+            p = stop;
+        } else {
+            const char* comma = last ? nullptr : static_cast<const char*>(memchr(p, ',', end - p));
+            const char* stop = comma ? comma : end;
+            field.append(p, stop - p);
+            p = stop;
+        }
+
+        if (p >= end) break;
+        ++p;                            // skip the comma
+        if (p == end && count < maxFields) {
+            fields[count++].clear();    // trailing empty field
+            break;
+        }
+    }
+    return count;
+}
+
+inline double parseDouble(string_view s) {
+    char buf[64];
+    size_t n = s.size() < sizeof(buf) - 1 ? s.size() : sizeof(buf) - 1;
+    memcpy(buf, s.data(), n);
+    buf[n] = '\0';
+    return strtod(buf, nullptr);
+}
+
+inline int parseInt(string_view s) {
+    int sign = 1, value = 0;
+    size_t i = 0;
+    while (i < s.size() && s[i] == ' ') ++i;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+')) sign = (s[i++] == '-') ? -1 : 1;
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) value = value * 10 + (s[i] - '0');
+    return sign * value;
+}
+
+// ---------------- Parallel Chunked Loader ----------------
+// The file is mapped read-only, cut into byte ranges that are moved forward
+// to the next row boundary (a newline outside quotes), and each range is
+// parsed on its own thread. Results come back per range, in file order, as
+// rows rather than column buffers: both backends store rows, so per-thread
+// columns would only be transposed back. Mapping keeps peak memory at the
+// parsed rows plus page cache instead of a second in-memory copy of the file.
+
+inline bool readWholeFile(const string& filename, string& contents) {
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (!f) return false;
+    contents.clear();
+    char chunk[1 << 16];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) contents.append(chunk, n);
+    fclose(f);
+    return true;
+}
+
+// Read-only view of a whole file: mmap on POSIX, a heap copy elsewhere.
+class MappedFile {
+public:
+    explicit MappedFile(const string& filename) {
+#ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            opened = true;
+            size = (size_t)st.st_size;
+            if (size > 0) {
+                void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    opened = false;
+                    size = 0;
+                } else {
+                    mapped = static_cast<const char*>(p);
+                    madvise(p, size, MADV_SEQUENTIAL);
+                }
+            }
+        }
+        close(fd);
+#else
+        opened = readWholeFile(filename, copy);
+        mapped = copy.data();
+        size = copy.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) munmap(const_cast<char*>(mapped), size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return opened; }
+    string_view view() const { return mapped ? string_view(mapped, size) : string_view(); }
+
+private:
+    const char* mapped = nullptr;
+    size_t size = 0;
+    bool opened = false;
+#ifdef _WIN32
+    string copy;
+#endif
+};
+
+// Returns parts + 1 offsets; rows of range i live in [offsets[i], offsets[i + 1]).
+inline vector<size_t> splitRowRanges(string_view data, size_t start, int parts) {
+    size_t size = data.size();
+    vector<size_t> naive(parts + 1);
+    for (int i = 0; i <= parts; ++i) naive[i] = start + (size - start) * i / parts;
+
+    // Quote parity of each naive range tells whether the next one starts
+    // inside a quoted field. Escaped quotes ("") cancel out.
+    vector<size_t> quotes(parts, 0);
+    vector<thread> workers;
+    for (int i = 0; i < parts; ++i) {
+        workers.emplace_back([&, i] {
+            size_t q = 0;
+            for (size_t p = naive[i]; p < naive[i + 1]; ++p) q += (data[p] == '"');
+            quotes[i] = q;
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    vector<size_t> offsets(parts + 1);
+    offsets[0] = start;
+    offsets[parts] = size;
+    size_t parity = 0;
+    for (int i = 1; i < parts; ++i) {
+        parity += quotes[i - 1];
+        bool inQuotes = parity & 1;
+        size_t p = naive[i];
+        while (p < size) {
+            char c = data[p++];
+            if (c == '"') inQuotes = !inQuotes;
+            else if (c == '\n' && !inQuotes) break;
+        }
+        offsets[i] = max(p, offsets[i - 1]);
+    }
+    return offsets;
+}
+
+// Calls onRow for every row in [begin, end), splitting on newlines outside quotes.
+template <typename OnRow>
+void forEachRow(string_view data, size_t begin, size_t end, OnRow onRow) {
+    size_t rowStart = begin;
+    bool inQuotes = false;
+    for (size_t p = begin; p < end; ++p) {
+        char c = data[p];
+        if (c == '"') inQuotes = !inQuotes;
+        else if (c == '\n' && !inQuotes) {
+            string_view row = data.substr(rowStart, p - rowStart);
+            if (!row.empty() && row.back() == '\r') row.remove_suffix(1);
+            onRow(row);
+            rowStart = p + 1;
+        }
+    }
+    if (rowStart < end) {
+        string_view row = data.substr(rowStart, end - rowStart);
+        if (!row.empty() && row.back() == '\r') row.remove_suffix(1);
+        onRow(row);
+    }
+}
+
+inline int defaultThreadCount() {
+    unsigned n = thread::hardware_concurrency();
+    return n == 0 ? 4 : (int)n;
+}
+
+// Parses every data row of a CSV file (header skipped) on `threads` threads.
+// parseRow(string_view row, T& out) returns false for rows to drop.
+template <typename T, typename ParseRow>
+bool parallelParseCSV(const string& filename, int threads, ParseRow parseRow, vector<vector<T>>& chunks) {
+    MappedFile file(filename);
+    if (!file.is_open()) return false;
+    string_view data = file.view();
+
+    size_t headerEnd = data.find('\n');
+    size_t start = (headerEnd == string::npos) ? data.size() : headerEnd + 1;
+    if (threads < 1) threads = 1;
+    // Small files are not worth the thread start-up cost
+    size_t maxThreads = (data.size() - start) / (64 * 1024) + 1;
+    if ((size_t)threads > maxThreads) threads = (int)maxThreads;
+
+    string_view view = data;
+    vector<size_t> offsets = splitRowRanges(view, start, threads);
+
+    chunks.assign(threads, vector<T>());
+    vector<thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i] {
+            T value;
+            forEachRow(view, offsets[i], offsets[i + 1], [&](string_view row) {
+                if (parseRow(row, value)) chunks[i].push_back(move(value));
+            });
+        });
+    }
+    for (auto& w : workers) w.join();
+    return true;
+}
+
+#endif // CSV_READER_HPP
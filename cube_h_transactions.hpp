@@ -0,0 +1,116 @@
+#ifndef TRANSACTION_CUBE_HPP
+#define TRANSACTION_CUBE_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "intern_h_pool.hpp"
+
+using namespace std;
+
+// ---------------- Category x Payment x Month Cube ----------------
+// Counts and price sums per (category, payment method, year-month). Every
+// record also updates the wildcard cells (ANY in any dimension), so any
+// "X paid with Y in month Z" ratio is two hash lookups. Built in one pass
+// (or per chunk and merged) and kept up to date by calling add() for each
+// appended record.
+
+struct CubeCell {
+    int count = 0;
+    double priceSum = 0.0;
+};
+
+// Full-width handles: the pool also holds every customer and product, so
+// category/payment handles are not small enough to pack into bit fields.
+struct CubeKey {
+    int category;
+    int payment;
+    int month;
+
+    bool operator==(const CubeKey& other) const {
+        return category == other.category && payment == other.payment && month == other.month;
+    }
+};
+
+struct CubeKeyHash {
+    size_t operator()(const CubeKey& k) const {
+        uint64_t h = ((uint64_t)(uint32_t)k.category << 32) | (uint32_t)k.payment;
+        h ^= (uint64_t)(uint32_t)k.month * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+        return (size_t)h;
+    }
+};
+
+class TransactionCube {
+public:
+    static const int ANY = -1;
+
+    // Works with the Record of either backend.
+    template <typename R>
+    void add(const R& r) {
+        addCell(r.category.handle(), r.paymentMethod.handle(), r.dateToInt() / 100, r.price);
+    }
+
+    template <typename R>
+    void build(const R* records, int count) {
+        for (int i = 0; i < count; ++i) add(records[i]);
+    }
+
+    // Cell-wise sum, for cubes built on separate chunks.
+    void merge(const TransactionCube& other) {
+        for (const auto& [key, c] : other.cells) {
+            CubeCell& mine = cells[key];
+            mine.count += c.count;
+            mine.priceSum += c.priceSum;
+        }
+    }
+
+    // Handles from globalStringPool(), month as YYYYMM; ANY is a wildcard.
+    CubeCell cell(int category, int payment, int month = ANY) const {
+        auto it = cells.find(CubeKey{category, payment, month});
+        return it == cells.end() ? CubeCell() : it->second;
+    }
+
+    // Inclusive month range, YYYYMM.
+    CubeCell cellInRange(int category, int payment, int fromMonth, int toMonth) const {
+        CubeCell total;
+        for (int m = fromMonth; m <= toMonth; m = nextMonth(m)) {
+            CubeCell c = cell(category, payment, m);
+            total.count += c.count;
+            total.priceSum += c.priceSum;
+        }
+        return total;
+    }
+
+    // Share (0-100) of `category` transactions paid with `payment`.
+    double percentage(int category, int payment, int month = ANY) const {
+        int total = cell(category, ANY, month).count;
+        int matched = cell(category, payment, month).count;
+        return total > 0 ? matched * 100.0 / total : 0.0;
+    }
+
+    size_t cellCount() const { return cells.size(); }
+
+private:
+    unordered_map<CubeKey, CubeCell, CubeKeyHash> cells;
+
+    static int nextMonth(int m) {
+        return (m % 100 == 12) ? (m / 100 + 1) * 100 + 1 : m + 1;
+    }
+
+    void addCell(int category, int payment, int month, double price) {
+        for (int mask = 0; mask < 8; ++mask) {
+            CubeCell& c = cells[CubeKey{mask & 1 ? ANY : category,
+                                        mask & 2 ? ANY : payment,
+                                        mask & 4 ? ANY : month}];
+            c.count++;
+            c.priceSum += price;
+        }
+    }
+};
+
+#endif // TRANSACTION_CUBE_HPP
@@ -0,0 +1,223 @@
+#ifndef INTERN_POOL_HPP
+#define INTERN_POOL_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// ---------------- String Interning Pool ----------------
+// Maps each distinct string to a small integer handle. The characters live
+// in arena blocks that never move, and each handle's entry sits in a chunk
+// that never moves either, so view() needs no lock and a view stays valid
+// for the life of the pool. intern() and find() take the pool's mutex, so
+// loader threads may intern concurrently. Handle 0 is the empty string.
+
+class StringPool {
+public:
+    StringPool() : slots(64, -1), chunks(new atomic<Entry*>[MAX_CHUNKS]) {
+        for (int i = 0; i < MAX_CHUNKS; ++i) chunks[i].store(nullptr, memory_order_relaxed);
+        internLocked(string_view());
+    }
+
+    ~StringPool() {
+        for (int i = 0; i < MAX_CHUNKS; ++i) delete[] chunks[i].load(memory_order_relaxed);
+    }
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Returns the handle for s, adding it on first sight.
+    int intern(string_view s) {
+        lock_guard<mutex> lock(mtx);
+        return internLocked(s);
+    }
+
+    // Returns the handle for s, or -1 if it was never interned.
+    int find(string_view s) const {
+        lock_guard<mutex> lock(mtx);
+        return lookup(s, hashOf(s));
+    }
+
+    string_view view(int id) const {
+        const Entry& e = entry(id);
+        return string_view(e.data, e.length);
+    }
+
+    int size() const { return count.load(memory_order_acquire); }
+
+    size_t arenaBytes() const {
+        lock_guard<mutex> lock(mtx);
+        return bytes;
+    }
+
+private:
+    struct Entry {
+        const char* data;
+        uint32_t length;
+        uint32_t hash;
+    };
+
+    static const int CHUNK_BITS = 16;                   // 64K entries per chunk
+    static const int MAX_CHUNKS = 1 << 15;              // 2^31 handles
+    static const size_t BLOCK_SIZE = 1 << 16;           // arena block, 64 KiB
+
+    mutable mutex mtx;
+    vector<int> slots;          // power-of-two sized, -1 marks an empty slot
+    unique_ptr<atomic<Entry*>[]> chunks;
+    vector<unique_ptr<char[]>> blocks;
+    char* blockFree = nullptr;
+    size_t blockLeft = 0;
+    size_t bytes = 0;
+    atomic<int> count{0};
+
+    // FNV-1a
+    static uint32_t hashOf(string_view s) {
+        uint32_t h = 2166136261u;
+        for (char c : s) {
+            h ^= (unsigned char)c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    const Entry& entry(int id) const {
+        return chunks[id >> CHUNK_BITS].load(memory_order_acquire)[id & ((1 << CHUNK_BITS) - 1)];
+    }
+
+    int lookup(string_view s, uint32_t h) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            int id = slots[i];
+            if (id < 0) return -1;
+            const Entry& e = entry(id);
+            if (e.hash == h && string_view(e.data, e.length) == s) return id;
+        }
+    }
+
+    int internLocked(string_view s) {
+        uint32_t h = hashOf(s);
+        int found = lookup(s, h);
+        if (found >= 0) return found;
+
+        int id = count.load(memory_order_relaxed);
+        chunkFor(id)[id & ((1 << CHUNK_BITS) - 1)] = Entry{store(s), (uint32_t)s.size(), h};
+        count.store(id + 1, memory_order_release);
+
+        if ((size_t)(id + 2) * 2 > slots.size()) rehash(slots.size() * 2);
+        else place(id);
+        return id;
+    }
+
+    // Chunk holding id, allocated on first use and then published.
+    Entry* chunkFor(int id) {
+        Entry* chunk = chunks[id >> CHUNK_BITS].load(memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Entry[1 << CHUNK_BITS];
+            chunks[id >> CHUNK_BITS].store(chunk, memory_order_release);
+        }
+        return chunk;
+    }
+
+    // Copies s into the arena; long strings get a block of their own.
+    const char* store(string_view s) {
+        if (s.empty()) return "";
+        bytes += s.size();
+        if (s.size() > BLOCK_SIZE / 4) {
+            blocks.emplace_back(new char[s.size() + 1]);
+            memcpy(blocks.back().get(), s.data(), s.size());
+            return blocks.back().get();
+        }
+        if (s.size() > blockLeft) {
+            blocks.emplace_back(new char[BLOCK_SIZE]);
+            blockFree = blocks.back().get();
+            blockLeft = BLOCK_SIZE;
+        }
+        char* p = blockFree;
+        memcpy(p, s.data(), s.size());
+        blockFree += s.size();
+        blockLeft -= s.size();
+        return p;
+    }
+
+    void place(int id) {
+        size_t mask = slots.size() - 1;
+        size_t i = entry(id).hash & mask;
+        while (slots[i] >= 0) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+
+    void rehash(size_t newSize) {
+        slots.assign(newSize, -1);
+        int n = count.load(memory_order_relaxed);
+        for (int id = 0; id < n; ++id) place(id);
+    }
+};
+
+// Shared by every dataset in the program, so handles from transactions and
+// reviews can be compared directly.
+inline StringPool& globalStringPool() {
+    static StringPool pool;
+    return pool;
+}
+
+// ---------------- Interned String Field ----------------
+// A 4-byte record field that stores only a globalStringPool() handle; the
+// characters are looked up when the field is read. Two fields are equal
+// exactly when their handles are, and ordering compares the characters.
+// Assigning a string interns it (thread-safe).
+
+class InternedString {
+public:
+    InternedString() = default;
+    explicit InternedString(string_view s) : id(globalStringPool().intern(s)) {}
+
+    InternedString& operator=(string_view s) {
+        id = globalStringPool().intern(s);
+        return *this;
+    }
+
+    // For handles already taken from globalStringPool()
+    static InternedString fromHandle(int handle) {
+        InternedString s;
+        s.id = handle;
+        return s;
+    }
+
+    int handle() const { return id; }
+    string_view view() const { return globalStringPool().view(id); }
+    operator string_view() const { return view(); }
+    string str() const { return string(view()); }
+
+    size_t size() const { return view().size(); }
+    size_t length() const { return view().size(); }
+    bool empty() const { return id == 0; }
+
+    bool operator==(const InternedString& other) const { return id == other.id; }
+    bool operator!=(const InternedString& other) const { return id != other.id; }
+    bool operator<(const InternedString& other) const { return id != other.id && view() < other.view(); }
+    bool operator>(const InternedString& other) const { return other < *this; }
+
+    friend bool operator==(const InternedString& a, string_view b) { return a.view() == b; }
+    friend bool operator==(string_view a, const InternedString& b) { return a == b.view(); }
+    friend bool operator!=(const InternedString& a, string_view b) { return a.view() != b; }
+    friend bool operator!=(string_view a, const InternedString& b) { return a != b.view(); }
+    friend bool operator<(const InternedString& a, string_view b) { return a.view() < b; }
+    friend bool operator<(string_view a, const InternedString& b) { return a < b.view(); }
+    friend bool operator>(const InternedString& a, string_view b) { return a.view() > b; }
+    friend bool operator>(string_view a, const InternedString& b) { return a > b.view(); }
+
+    friend ostream& operator<<(ostream& os, const InternedString& s) { return os << s.view(); }
+
+private:
+    int32_t id = 0;
+};
+
+#endif // INTERN_POOL_HPP
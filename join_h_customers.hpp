@@ -0,0 +1,190 @@
+#ifndef CUSTOMER_JOIN_HPP
+#define CUSTOMER_JOIN_HPP
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+using namespace std;
+
+// ---------------- Customer Hash Join ----------------
+// Equi-join on interned customer handles (globalStringPool()). Both sides
+// are given as one key per row, so the join only ever deals in row IDs;
+// callers look records up by index instead of copying them.
+// Build side: usually transactions. Probe side: usually reviews.
+
+struct JoinPair {
+    int32_t probeRow;
+    int32_t buildRow;
+};
+
+// Open-addressed key -> chain of build rows. Chains are linked through a
+// per-row `next` array, so the table holds one slot per distinct key.
+class CustomerHashTable {
+public:
+    // Fibonacci hashing; the radix join partitions on the top bits and the
+    // table indexes with the bottom bits, so the two stay independent.
+    static uint32_t hashKey(int32_t key) { return (uint32_t)key * 2654435769u; }
+
+    void build(const int32_t* keys, int count) {
+        size_t capacity = 16;
+        while (capacity < (size_t)count * 2) capacity <<= 1;
+        mask = capacity - 1;
+        slotKey.assign(capacity, -1);
+        slotHead.assign(capacity, -1);
+        next.assign(count, -1);
+
+        // Walk backwards so every chain lists its rows in ascending order
+        for (int row = count - 1; row >= 0; --row) {
+            size_t s = slotOf(keys[row]);
+            slotKey[s] = keys[row];
+            next[row] = slotHead[s];
+            slotHead[s] = row;
+        }
+    }
+
+    // Calls fn(buildRow) for every build row with this key.
+    template <typename Fn>
+    void probe(int32_t key, Fn fn) const {
+        if (slotKey.empty()) return;
+        for (int row = slotHead[slotOf(key)]; row >= 0; row = next[row]) fn(row);
+    }
+
+private:
+    vector<int32_t> slotKey;    // -1 marks an empty slot
+    vector<int32_t> slotHead;
+    vector<int32_t> next;
+    size_t mask = 0;
+
+    size_t slotOf(int32_t key) const {
+        size_t s = hashKey(key) & mask;
+        while (slotKey[s] >= 0 && slotKey[s] != key) s = (s + 1) & mask;
+        return s;
+    }
+};
+
+// Streams fn(probeRow, buildRow) in probe-row order.
+template <typename Fn>
+void hashJoin(const int32_t* buildKeys, int buildCount, const int32_t* probeKeys, int probeCount, Fn fn) {
+    CustomerHashTable table;
+    table.build(buildKeys, buildCount);
+    for (int p = 0; p < probeCount; ++p) {
+        table.probe(probeKeys[p], [&](int b) { fn(p, b); });
+    }
+}
+
+inline vector<JoinPair> hashJoinPairs(const int32_t* buildKeys, int buildCount, const int32_t* probeKeys, int probeCount) {
+    vector<JoinPair> out;
+    hashJoin(buildKeys, buildCount, probeKeys, probeCount,
+             [&](int p, int b) { out.push_back(JoinPair{p, b}); });
+    return out;
+}
+
+namespace join_detail {
+
+// Rows regrouped by partition; partition i is [offsets[i], offsets[i + 1]).
+// Within a partition rows keep their input order.
+struct Partitioned {
+    vector<int32_t> keys;
+    vector<int32_t> rows;
+    vector<int> offsets;
+};
+
+inline Partitioned radixPartition(const int32_t* keys, int count, int bits, int threads) {
+    int parts = 1 << bits;
+    int shift = 32 - bits;
+    Partitioned out;
+    out.keys.resize(count);
+    out.rows.resize(count);
+    out.offsets.assign(parts + 1, 0);
+
+    // Pass 1: per-thread histograms over contiguous chunks
+    vector<vector<int>> histogram(threads, vector<int>(parts, 0));
+    auto chunkBegin = [&](int t) { return (int)((long long)count * t / threads); };
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = chunkBegin(t); i < chunkBegin(t + 1); ++i)
+                histogram[t][CustomerHashTable::hashKey(keys[i]) >> shift]++;
+        });
+    }
+    for (auto& w : workers) w.join();
+    workers.clear();
+
+    // Each thread writes its slice of every partition, chunks in input order
+    vector<vector<int>> cursor(threads, vector<int>(parts, 0));
+    int position = 0;
+    for (int p = 0; p < parts; ++p) {
+        out.offsets[p] = position;
+        for (int t = 0; t < threads; ++t) {
+            cursor[t][p] = position;
+            position += histogram[t][p];
+        }
+    }
+    out.offsets[parts] = position;
+
+    // Pass 2: scatter
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            vector<int>& pos = cursor[t];
+            for (int i = chunkBegin(t); i < chunkBegin(t + 1); ++i) {
+                int dst = pos[CustomerHashTable::hashKey(keys[i]) >> shift]++;
+                out.keys[dst] = keys[i];
+                out.rows[dst] = i;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    return out;
+}
+
+} // namespace join_detail
+
+// Radix-partitioned parallel join: both sides are split into 2^radixBits
+// partitions by key hash, then threads join partitions independently, each
+// with a hash table small enough to stay in cache. Output is grouped by
+// partition (probe-row order within each); sort by probeRow if the
+// sequential order is needed. Small inputs fall back to hashJoinPairs.
+inline vector<JoinPair> radixHashJoin(const int32_t* buildKeys, int buildCount,
+                                      const int32_t* probeKeys, int probeCount,
+                                      int threads, int radixBits = 6) {
+    if (threads < 1) threads = 1;
+    if (threads == 1 || buildCount + probeCount < (1 << 16))
+        return hashJoinPairs(buildKeys, buildCount, probeKeys, probeCount);
+
+    join_detail::Partitioned build = join_detail::radixPartition(buildKeys, buildCount, radixBits, threads);
+    join_detail::Partitioned probe = join_detail::radixPartition(probeKeys, probeCount, radixBits, threads);
+
+    int parts = 1 << radixBits;
+    vector<vector<JoinPair>> results(parts);
+    atomic<int> nextPartition(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            CustomerHashTable table;
+            for (int p = nextPartition++; p < parts; p = nextPartition++) {
+                int b0 = build.offsets[p], b1 = build.offsets[p + 1];
+                int q0 = probe.offsets[p], q1 = probe.offsets[p + 1];
+                if (b0 == b1 || q0 == q1) continue;
+                table.build(build.keys.data() + b0, b1 - b0);
+                for (int q = q0; q < q1; ++q) {
+                    table.probe(probe.keys[q], [&](int local) {
+                        results[p].push_back(JoinPair{probe.rows[q], build.rows[b0 + local]});
+                    });
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    size_t total = 0;
+    for (const auto& r : results) total += r.size();
+    vector<JoinPair> out;
+    out.reserve(total);
+    for (const auto& r : results) out.insert(out.end(), r.begin(), r.end());
+    return out;
+}
+
+#endif // CUSTOMER_JOIN_HPP
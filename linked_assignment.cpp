@@ -10,7 +10,13 @@
 #include <map>
 #include <cmath>
 #include <iomanip> 
+#include <vector>
+#include <queue>
+#include <string_view>
 #include "linked_h_assignment.hpp"
+#include "csv_h_reader.hpp"
+#include "intern_h_pool.hpp"
+#include "cube_h_transactions.hpp"
 
 
 using namespace std;
@@ -33,69 +39,145 @@ void appendTransactionNode(TransactionNode*& head, TransactionNode* newNode) {
     }
 }
 
+bool parseTransactionRow(string_view line, Record& record) {
+    string fields[6];
+    if (parseCSVRecord(line, fields, 6) < 6) return false;
+    // Text fields are interned as they are parsed (the pool is thread-safe)
+    record.customerID = fields[0];
+    record.product = fields[1];
+    record.category = fields[2];
+    record.price = parseDouble(fields[3]);
+    record.date = fields[4];
+    record.paymentMethod = fields[5];
+    return true;
+}
+
 TransactionNode* readTransactionCSV(const string& filename) {
-    ifstream file(filename);
-    string line;
+    if (isColumnarFile(filename)) return readTransactionColumnar(filename);
+
+    AsyncLineReader reader(filename);
+    string_view line;
     TransactionNode* head = nullptr;
+    TransactionNode* tail = nullptr;
 
-    if (!file.is_open()) {
+    if (!reader.is_open()) {
         cerr << "Error: Could not open transaction file." << endl;
         return nullptr;
     }
 
-    getline(file, line); // Skip header
+    reader.nextRecord(line); // Skip header
 
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string customerID, product, category, priceStr, date, paymentMethod;
-        getline(ss, customerID, ',');
-        getline(ss, product, ',');
-        getline(ss, category, ',');
-        getline(ss, priceStr, ',');
-        getline(ss, date, ',');
-        getline(ss, paymentMethod, ',');
+    Record record;
+    while (reader.nextRecord(line)) {
+        if (!parseTransactionRow(line, record)) continue;
 
-        double price = stod(priceStr);
-
-        Record record = {customerID, product, category, price, date, paymentMethod};
         TransactionNode* newNode = createTransactionNode(record);
-        appendTransactionNode(head, newNode);
+
+        // Keep a tail pointer so loading stays linear
+        if (!head) head = newNode;
+        else tail->next = newNode;
+        tail = newNode;
     }
 
-    file.close();
+    return head;
+}
+
+// One cube per parsed chunk on its own thread, then merged into `cube`
+static void buildCubeFromChunks(const vector<vector<Record>>& chunks, TransactionCube& cube) {
+    vector<TransactionCube> partial(chunks.size());
+    vector<thread> workers;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        workers.emplace_back([&, i] { partial[i].build(chunks[i].data(), (int)chunks[i].size()); });
+    }
+    for (auto& w : workers) w.join();
+    for (const auto& p : partial) cube.merge(p);
+}
+
+// Parallel loader: chunks are parsed concurrently, then linked in file order.
+// With `stats` / `cube`, every chunk is summarised on its own thread and merged in
+TransactionNode* readTransactionCSVParallel(const string& filename, int threads, TransactionStats* stats,
+                                            TransactionCube* cube) {
+    if (isColumnarFile(filename)) {
+        TransactionNode* head = readTransactionColumnar(filename);
+        for (TransactionNode* t = head; t && (stats || cube); t = t->next) {
+            if (stats) stats->add(t->data);
+            if (cube) cube->add(t->data);
+        }
+        return head;
+    }
+
+    vector<vector<Record>> chunks;
+    if (!parallelParseCSV<Record>(filename, threads, parseTransactionRow, chunks)) {
+        cerr << "Error: Could not open transaction file." << endl;
+        return nullptr;
+    }
+
+    if (stats) {
+        vector<TransactionStats> partial(chunks.size(), stats->emptyCopy());
+        vector<thread> workers;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&, i] {
+                for (const auto& record : chunks[i]) partial[i].add(record);
+            });
+        }
+        for (auto& w : workers) w.join();
+        for (const auto& p : partial) stats->merge(p);
+    }
+    if (cube) buildCubeFromChunks(chunks, *cube);
+
+    TransactionNode* head = nullptr;
+    TransactionNode** tail = &head;
+    for (auto& chunk : chunks) {
+        for (auto& record : chunk) {
+            *tail = createTransactionNode(move(record));
+            tail = &(*tail)->next;
+        }
+    }
     return head;
 }
 
 // ---------------- Sorting Algorithms ----------------
 
+// Bubble and selection sort relink nodes instead of swapping the Record
+// payloads, so no strings are copied while sorting.
 TransactionNode* bubbleSort(TransactionNode* head) {
     if (!head) return nullptr;
     bool swapped;
     do {
         swapped = false;
-        TransactionNode* current = head;
-        while (current->next) {
-            if (current->data.dateToInt() > current->next->data.dateToInt()) {
-                swap(current->data, current->next->data);
+        TransactionNode** link = &head;
+        while ((*link)->next) {
+            TransactionNode* current = *link;
+            TransactionNode* next = current->next;
+            if (current->data.dateToInt() > next->data.dateToInt()) {
+                current->next = next->next;
+                next->next = current;
+                *link = next;
                 swapped = true;
             }
-            current = current->next;
+            link = &(*link)->next;
         }
     } while (swapped);
     return head;
 }
 
 TransactionNode* selectionSort(TransactionNode* head) {
-    for (TransactionNode* current = head; current; current = current->next) {
-        TransactionNode* minNode = current;
-        for (TransactionNode* next = current->next; next; next = next->next) {
-            if (next->data.dateToInt() < minNode->data.dateToInt())
-                minNode = next;
+    TransactionNode* sorted = nullptr;
+    TransactionNode** tail = &sorted;
+    while (head) {
+        // Find the link that points at the minimum of the unsorted part
+        TransactionNode** minLink = &head;
+        for (TransactionNode** link = &head->next; *link; link = &(*link)->next) {
+            if ((*link)->data.dateToInt() < (*minLink)->data.dateToInt())
+                minLink = link;
         }
-        if (minNode != current)
-            swap(current->data, minNode->data);
+        TransactionNode* minNode = *minLink;
+        *minLink = minNode->next;
+        minNode->next = nullptr;
+        *tail = minNode;
+        tail = &minNode->next;
     }
-    return head;
+    return sorted;
 }
 
 TransactionNode* insertionSort(TransactionNode*& head) {
@@ -152,24 +234,88 @@ TransactionNode* mergeSort(TransactionNode* head) {
 }
 
 
+// Stable sort on a string field: the multikey string sort orders the node
+// pointers, then one pass relinks them.
+TransactionNode* sortByText(TransactionNode* head, InternedString Record::*field) {
+    vector<TransactionNode*> nodes;
+    for (TransactionNode* n = head; n; n = n->next) nodes.push_back(n);
+    if (nodes.size() < 2) return head;
+
+    vector<int32_t> order = stringSortOrder((int)nodes.size(),
+                                            [&](int i) { return (nodes[i]->data.*field).view(); });
+    for (size_t i = 0; i + 1 < order.size(); ++i) nodes[order[i]]->next = nodes[order[i + 1]];
+    nodes[order.back()]->next = nullptr;
+    return nodes[order[0]];
+}
+
+// ---------------- Top-K Selection ----------------
+
+bool compareRecords(const Record& a, const Record& b, SortMode mode) {
+    switch (mode) {
+        case BY_DATE:
+            return a.dateToInt() < b.dateToInt();
+        case BY_CATEGORY:
+            return a.category < b.category;
+        case BY_PRICE:
+            return a.price < b.price;
+        default:
+            return false;
+    }
+}
+
+// Keeps the k largest records in a bounded min-heap (O(n log k)) and returns
+// them as a new list, largest first. The input list is left untouched.
+TransactionNode* topK(TransactionNode* head, int k, SortMode mode) {
+    if (k <= 0) return nullptr;
+
+    auto smallestOnTop = [mode](const Record* a, const Record* b) {
+        return compareRecords(*b, *a, mode);
+    };
+    priority_queue<const Record*, vector<const Record*>, decltype(smallestOnTop)> heap(smallestOnTop);
+
+    for (TransactionNode* current = head; current; current = current->next) {
+        if ((int)heap.size() < k) heap.push(&current->data);
+        else if (compareRecords(*heap.top(), current->data, mode)) {
+            heap.pop();
+            heap.push(&current->data);
+        }
+    }
+
+    // Popping yields smallest first, so prepend to get largest first
+    TransactionNode* result = nullptr;
+    while (!heap.empty()) {
+        TransactionNode* node = createTransactionNode(*heap.top());
+        heap.pop();
+        node->next = result;
+        result = node;
+    }
+    return result;
+}
+
+
 // ---------------- Searching algorithms ----------------
+static void printTransaction(OutputWriter& out, const Record& r) {
+    out << "Customer ID: " << r.customerID << "\n";
+    out << "Product: " << r.product << "\n";
+    out << "Category: " << r.category << "\n";
+    out << "Price: $" << r.price << "\n";
+    out << "Date: " << r.date << "\n";
+    out << "Payment Method: " << r.paymentMethod << "\n\n";
+}
+
 // Linear Search
 void linearSearchByDate(TransactionNode* head, const string& targetDate) {
+    OutputWriter out;
     bool found = false;
     while (head) {
         if (head->data.date == targetDate) {
-            cout << "Customer ID: " << head->data.customerID << "\n";
-            cout << "Product: " << head->data.product << "\n";
-            cout << "Category: " << head->data.category << "\n";
-            cout << "Price: $" << head->data.price << "\n";
-            cout << "Date: " << head->data.date << "\n";
-            cout << "Payment Method: " << head->data.paymentMethod << "\n\n";
+            printTransaction(out, head->data);
             found = true;
         }
         head = head->next;
     }
     if (!found) {
-        cout << "No transactions found on the given date.\n";
+        out << "No transactions found on the given date.\n";
     }
 }
 
@@ -211,6 +357,7 @@ TransactionNode* binarySearch(TransactionNode* head, const string& targetDate) {
 }
 
 void binarySearchByDate(TransactionNode* head, const string& targetDate) {
+    OutputWriter out;
     TransactionNode* current = head;
     bool found = false;
 
@@ -218,34 +365,26 @@ void binarySearchByDate(TransactionNode* head, const string& targetDate) {
     while (current) {
         if (current->data.date == targetDate) {
             if (!found) {
-                cout << "Transactions found on date " << targetDate << ":\n";
+                out << "Transactions found on date " << targetDate << ":\n";
                 found = true;
             }
-            cout << "Customer ID: " << current->data.customerID << "\n";
-            cout << "Product: " << current->data.product << "\n";
-            cout << "Category: " << current->data.category << "\n";
-            cout << "Price: $" << current->data.price << "\n";
-            cout << "Date: " << current->data.date << "\n";
-            cout << "Payment Method: " << current->data.paymentMethod << "\n\n";
+            printTransaction(out, current->data);
         }
         current = current->next;
     }
 
     if (!found) {
-        cout << "No transactions found for the given date.\n";
+        out << "No transactions found for the given date.\n";
     }
 }
 
 // Jump Search
-int dateToInt(const string& date) {
-    // Date format is DD/MM/YYYY
-    int day = stoi(date.substr(0, 2));
-    int month = stoi(date.substr(3, 2));
-    int year = stoi(date.substr(6, 4));
-    return year * 10000 + month * 100 + day; // YYYYMMDD format
+int dateToInt(string_view date) {
+    return dateKey(date); // YYYYMMDD format
 }
 
 void jumpSearchByDate(TransactionNode* head, const string& targetDate) {
+    OutputWriter out;
     // if (!head) {
     //     cout << "No transactions found for the given date.\n";
     //     return;
@@ -281,39 +420,35 @@ void jumpSearchByDate(TransactionNode* head, const string& targetDate) {
     while (temp != curr->next) { // careful: must check up to curr
         if (temp->data.date == targetDate) {
             if (!found) {
-                cout << "Transactions found on date " << targetDate << ":\n";
+                out << "Transactions found on date " << targetDate << ":\n";
                 found = true;
             }
-            cout << "Customer ID: " << temp->data.customerID << "\n";
-            cout << "Product: " << temp->data.product << "\n";
-            cout << "Category: " << temp->data.category << "\n";
-            cout << "Price: $" << temp->data.price << "\n";
-            cout << "Date: " << temp->data.date << "\n";
-            cout << "Payment Method: " << temp->data.paymentMethod << "\n\n";
+            printTransaction(out, temp->data);
         }
         temp = temp->next;
     }
 
     if (!found) {
-        cout << "No transactions found for the given date.\n";
+        out << "No transactions found for the given date.\n";
     }
 }
 
 // Interpolation search 
 void interpolationSearchByDate(TransactionNode* head, const string& targetDate) {
+    OutputWriter out;
     if (!head) {
-        cout << "No transactions found.\n";
+        out << "No transactions found.\n";
         return;
     }
 
     bool found = false;
-    cout << "Transactions found on date " << targetDate << ":\n";
+    out << "Transactions found on date " << targetDate << ":\n";
 
     // Count total number of nodes and find min/max dates
     int n = 0;
     TransactionNode* temp = head;
-    string minDate = temp->data.date;
-    string maxDate = temp->data.date;
+    string_view minDate = temp->data.date;
+    string_view maxDate = temp->data.date;
     
     while (temp) {
         n++;
@@ -328,7 +463,7 @@ void interpolationSearchByDate(TransactionNode* head, const string& targetDate)
 
     // Check if target date is outside the range
     if (dateToInt(targetDate) < dateToInt(minDate) || dateToInt(targetDate) > dateToInt(maxDate)) {
-        cout << "No transactions found on date " << targetDate << ".\n";
+        out << "No transactions found on date " << targetDate << ".\n";
         return;
     }
 
@@ -364,12 +499,7 @@ void interpolationSearchByDate(TransactionNode* head, const string& targetDate)
     
     // Now, print all transactions with the target date
     while (current && current->data.date == targetDate) {
-        cout << "Customer ID: " << current->data.customerID << "\n";
-        cout << "Product: " << current->data.product << "\n";
-        cout << "Category: " << current->data.category << "\n";
-        cout << "Price: $" << current->data.price << "\n";
-        cout << "Date: " << current->data.date << "\n";
-        cout << "Payment Method: " << current->data.paymentMethod << "\n\n";
+        printTransaction(out, current->data);
         
         found = true;
         current = current->next;
@@ -382,12 +512,7 @@ void interpolationSearchByDate(TransactionNode* head, const string& targetDate)
         if (current->data.date == targetDate) {
             // Check if we already printed this transaction
             if (!found) {
-                cout << "Customer ID: " << current->data.customerID << "\n";
-                cout << "Product: " << current->data.product << "\n";
-                cout << "Category: " << current->data.category << "\n";
-                cout << "Price: $" << current->data.price << "\n";
-                cout << "Date: " << current->data.date << "\n";
-                cout << "Payment Method: " << current->data.paymentMethod << "\n\n";
+                printTransaction(out, current->data);
                 found = true;
             }
         }
@@ -395,20 +520,16 @@ void interpolationSearchByDate(TransactionNode* head, const string& targetDate)
     }
     
     if (!found) {
-        cout << "No transactions found on date " << targetDate << ".\n";
+        out << "No transactions found on date " << targetDate << ".\n";
     }
 }
 
 // ---------------- Display Transactions ----------------
 
 void displayTransactions(TransactionNode* head) {
+    OutputWriter out;
     while (head) {
-        cout << "Customer ID: " << head->data.customerID << "\n";
-        cout << "Product: " << head->data.product << "\n";
-        cout << "Category: " << head->data.category << "\n";
-        cout << "Price: $" << head->data.price << "\n";
-        cout << "Date: " << head->data.date << "\n";
-        cout << "Payment Method: " << head->data.paymentMethod << "\n\n";
+        printTransaction(out, head->data);
         head = head->next;
     }
 }
@@ -417,9 +538,8 @@ void displayTransactions(TransactionNode* head) {
 
 
 
-ReviewNode* createReviewNode(const string& product_id, const string& customer_id, int rating, const string& review) {
-    auto node = new ReviewNode{product_id, customer_id, rating, review, nullptr};
-    return node;
+ReviewNode* createReviewNode(string_view product_id, string_view customer_id, int rating, const string& review) {
+    return new ReviewNode{InternedString(product_id), InternedString(customer_id), rating, review, nullptr};
 }
 
 void appendReviewNode(ReviewNode** head, ReviewNode* node) {
@@ -431,16 +551,52 @@ void appendReviewNode(ReviewNode** head, ReviewNode* node) {
     }
 }
 
+static void printReview(OutputWriter& out, const ReviewNode& r) {
+    out << "Product ID: " << r.product_id << "\n";
+    out << "Customer ID: " << r.customer_id << "\n";
+    out << "Rating: " << r.rating << "\n";
+    out << "Review: " << r.review << "\n\n";
+}
+
 void displayReviews(ReviewNode* head) {
+    OutputWriter out;
     while (head) {
-        cout << "Product ID: " << head->product_id << "\n";
-        cout << "Customer ID: " << head->customer_id << "\n";
-        cout << "Rating: " << head->rating << "\n";
-        cout << "Review: " << head->review << "\n\n";
+        printReview(out, *head);
         head = head->link;
     }
 }
 
+bool parseReviewRow(string_view line, ReviewNode& review) {
+    string fields[4];
+    if (parseCSVRecord(line, fields, 4) < 4 || fields[3].empty()) return false;
+    review.product_id = fields[0];
+    review.customer_id = fields[1];
+    review.rating = parseInt(fields[2]);
+    review.review = move(fields[3]);
+    review.link = nullptr;
+    return true;
+}
+
+ReviewNode* readReviewCSVParallel(const string& filename, int threads) {
+    if (isColumnarFile(filename)) return readReviewColumnar(filename);
+
+    vector<vector<ReviewNode>> chunks;
+    if (!parallelParseCSV<ReviewNode>(filename, threads, parseReviewRow, chunks)) {
+        cerr << "Error: Could not open review file." << endl;
+        return nullptr;
+    }
+
+    ReviewNode* head = nullptr;
+    ReviewNode** tail = &head;
+    for (auto& chunk : chunks) {
+        for (auto& review : chunk) {
+            *tail = new ReviewNode(move(review));
+            tail = &(*tail)->link;
+        }
+    }
+    return head;
+}
+
 int countReviews(ReviewNode* head) {
     int count = 0;
     while (head) {
@@ -453,15 +609,16 @@ int countReviews(ReviewNode* head) {
 // ---------------- Filter Reviews ----------------
 
 void filterReviews(ReviewNode** reviewHeadRef, TransactionNode* transactionHead, bool debug = false) {
-    unordered_map<string, int> transactionCounts;
+    StringPool& pool = globalStringPool();
 
-    // Step 1: Count number of transactions per customer
+    // Step 1: Count number of transactions per customer (indexed by interned handle)
+    vector<int> transactionCounts(pool.size(), 0);
     while (transactionHead) {
-        transactionCounts[transactionHead->data.customerID]++;
+        transactionCounts[transactionHead->data.customerID.handle()]++;
         transactionHead = transactionHead->next;
     }
 
-    unordered_map<string, int> reviewCounts;
+    vector<int> reviewCounts(pool.size(), 0);
 
     // Step 2: Use a dummy node for easier head deletion
     ReviewNode dummy;
@@ -470,8 +627,8 @@ void filterReviews(ReviewNode** reviewHeadRef, TransactionNode* transactionHead,
     ReviewNode* current = dummy.link;
 
     while (current) {
-        string cid = current->customer_id;
-        int allowed = transactionCounts.count(cid) ? transactionCounts[cid] : 0;
+        int cid = current->customer_id.handle();
+        int allowed = transactionCounts[cid];
 
         if (reviewCounts[cid] < allowed) {
             // Keep this review
@@ -481,7 +638,7 @@ void filterReviews(ReviewNode** reviewHeadRef, TransactionNode* transactionHead,
         } else {
             // Delete the review
             if (debug) {
-                cout << "Deleting extra review by customer: " << cid << endl;
+                cout << "Deleting extra review by customer: " << current->customer_id << endl;
             }
 
             ReviewNode* toDelete = current;
@@ -495,28 +652,140 @@ void filterReviews(ReviewNode** reviewHeadRef, TransactionNode* transactionHead,
     *reviewHeadRef = dummy.link;
 }
 
+// ---------------- Customer Join ----------------
+
+// One key per node, in list order
+static vector<int32_t> customerKeysOf(ReviewNode* reviews) {
+    vector<int32_t> keys;
+    for (ReviewNode* r = reviews; r; r = r->link) keys.push_back(r->customer_id.handle());
+    return keys;
+}
+
+static vector<int32_t> customerKeysOf(TransactionNode* transactions, vector<const Record*>* rows = nullptr) {
+    vector<int32_t> keys;
+    for (TransactionNode* t = transactions; t; t = t->next) {
+        keys.push_back(t->data.customerID.handle());
+        if (rows) rows->push_back(&t->data);
+    }
+    return keys;
+}
+
+vector<JoinPair> joinReviewsToTransactions(ReviewNode* reviews, TransactionNode* transactions, int threads) {
+    vector<int32_t> reviewKeys = customerKeysOf(reviews);
+    vector<int32_t> transactionKeys = customerKeysOf(transactions);
+    if (threads <= 1)
+        return hashJoinPairs(transactionKeys.data(), (int)transactionKeys.size(), reviewKeys.data(), (int)reviewKeys.size());
+
+    vector<JoinPair> pairs = radixHashJoin(transactionKeys.data(), (int)transactionKeys.size(),
+                                           reviewKeys.data(), (int)reviewKeys.size(), threads);
+    sort(pairs.begin(), pairs.end(), [](const JoinPair& a, const JoinPair& b) {
+        return a.probeRow != b.probeRow ? a.probeRow < b.probeRow : a.buildRow < b.buildRow;
+    });
+    return pairs;
+}
+
+// Streams each review with every transaction of the same customer, no copies
+void forEachReviewTransaction(ReviewNode* reviews, TransactionNode* transactions,
+                              const function<void(const ReviewNode&, const Record&)>& fn) {
+    vector<const Record*> rows;
+    vector<int32_t> transactionKeys = customerKeysOf(transactions, &rows);
+
+    CustomerHashTable table;
+    table.build(transactionKeys.data(), (int)transactionKeys.size());
+    for (ReviewNode* r = reviews; r; r = r->link)
+        table.probe(r->customer_id.handle(), [&](int t) { fn(*r, *rows[t]); });
+}
+
 // ---------------- Save Reviews to CSV ----------------
 
-void saveReviewsToCSV(ReviewNode* head, const string& filename) {
-    ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        cerr << "Error: Could not open output file." << endl;
-        return;
+static void writeReviewRow(OutputWriter& out, const ReviewNode& review) {
+    out << review.product_id << ',' << review.customer_id << ',' << review.rating << ',' << '"';
+    // Escape embedded quotes as "" so the file reads back unchanged;
+    // unquoted runs are copied in one piece
+    string_view text = review.review;
+    size_t quote;
+    while ((quote = text.find('"')) != string_view::npos) {
+        out << text.substr(0, quote + 1) << '"';
+        text.remove_prefix(quote + 1);
     }
+    out << text << '"' << '\n';
+}
+
+// Text mode, like the ofstream this replaced
+static FILE* openReviewCSV(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file) cerr << "Error: Could not open output file." << endl;
+    return file;
+}
 
-    outFile << "product_id,customer_id,rating,review\n";
+void saveReviewsToCSV(ReviewNode* head, const string& filename) {
+    FILE* file = openReviewCSV(filename);
+    if (!file) return;
 
-    ReviewNode* current = head;
-    while (current != nullptr) {
-        outFile << current->product_id << ',' << current->customer_id << ',' 
-                << current->rating << ',' << '"' << current->review << '"' << '\n';
-        current = current->link;
+    {
+        OutputWriter outFile(file);
+        outFile << "product_id,customer_id,rating,review\n";
+
+        ReviewNode* current = head;
+        while (current != nullptr) {
+            writeReviewRow(outFile, *current);
+            current = current->link;
+        }
     }
 
-    outFile.close();
+    fclose(file);
     cout << "\nFiltered reviews saved to '" << filename << "'" << endl;
 }
 
+// ---------------- Columnar Storage ----------------
+
+bool saveTransactionsColumnar(TransactionNode* head, const string& filename) {
+    vector<const Record*> rows;
+    for (TransactionNode* t = head; t; t = t->next) rows.push_back(&t->data);
+    return writeTransactionsColumnar(filename, (int)rows.size(), [&](int i) -> const Record& { return *rows[i]; });
+}
+
+bool saveReviewsColumnar(ReviewNode* head, const string& filename) {
+    vector<const ReviewNode*> rows;
+    for (ReviewNode* r = head; r; r = r->link) rows.push_back(r);
+    return writeReviewsColumnar(filename, (int)rows.size(), [&](int i) -> const ReviewNode& { return *rows[i]; });
+}
+
+// Row groups the predicate rules out are skipped without being read.
+TransactionNode* readTransactionColumnar(const string& filename, const TransactionPredicate& pred,
+                                         ColumnarScanInfo* scan) {
+    vector<Record> rows;
+    if (!readTransactionsColumnar(filename, rows, pred, scan)) {
+        cerr << "Error: Could not read columnar transaction file." << endl;
+        return nullptr;
+    }
+
+    TransactionNode* head = nullptr;
+    TransactionNode** tail = &head;
+    for (auto& record : rows) {
+        *tail = createTransactionNode(move(record));
+        tail = &(*tail)->next;
+    }
+    return head;
+}
+
+ReviewNode* readReviewColumnar(const string& filename, const ReviewPredicate& pred, ColumnarScanInfo* scan) {
+    vector<ReviewNode> rows;
+    if (!readReviewsColumnar(filename, rows, pred, scan)) {
+        cerr << "Error: Could not read columnar review file." << endl;
+        return nullptr;
+    }
+
+    ReviewNode* head = nullptr;
+    ReviewNode** tail = &head;
+    for (auto& review : rows) {
+        review.link = nullptr;
+        *tail = new ReviewNode(move(review));
+        tail = &(*tail)->link;
+    }
+    return head;
+}
+
 // Clean a word (remove punctuation, lowercase)
 string cleanWord(const string& word) {
     string cleaned;
@@ -559,6 +828,40 @@ ReviewNode* mergeSortByReviewLength(ReviewNode* head) {
     return mergeByReviewLength(left, right);
 }
 
+// Counting sort on length: one walk to collect the lengths, one relinking
+// pass. Equal lengths come out in reverse input order, exactly as the
+// merge above leaves them.
+ReviewNode* bucketSortByReviewLength(ReviewNode* head) {
+    return bucketSortList(head, &ReviewNode::link,
+                          [](const ReviewNode& r) { return (int)r.review.length(); }, true, true);
+}
+
+// Stable (ties keep list order) on any integer key, e.g. BY_RATING
+ReviewNode* bucketSortReviews(ReviewNode* head, ReviewSortKey key, bool descending) {
+    return bucketSortList(head, &ReviewNode::link,
+                          [key](const ReviewNode& r) { return reviewSortKey(r, key); }, descending, false);
+}
+
+
+static void printOneStarWordFrequencies(const unordered_map<string, int>& wordFreq) {
+    OutputWriter out;
+    if (wordFreq.empty()) {
+        out << "No 1-star reviews found.\n";
+    } else {
+        // Create a multimap to sort words by frequency in descending order
+        multimap<int, string, greater<int>> sortedWords;
+
+        // Insert words into the multimap with frequency as the key
+        for (const auto& pair : wordFreq) {
+            sortedWords.insert({pair.second, pair.first});
+        }
+
+        out << "\nWord frequencies in 1-star reviews (sorted by frequency):\n";
+        for (const auto& pair : sortedWords) {
+            out << pair.second << ": " << pair.first << '\n';
+        }
+    }
+}
 
 // Display word frequencies in 1-star reviews sorted in descending order
 void displayWordFrequenciesInOneStarReviews(ReviewNode* head) {
@@ -576,24 +879,67 @@ void displayWordFrequenciesInOneStarReviews(ReviewNode* head) {
         head = head->link;
     }
 
-    if (wordFreq.empty()) {
-        cout << "No 1-star reviews found." << endl;
-    } else {
-        // Create a multimap to sort words by frequency in descending order
-        multimap<int, string, greater<int>> sortedWords;
+    printOneStarWordFrequencies(wordFreq);
+}
 
-        // Insert words into the multimap with frequency as the key
-        for (const auto& pair : wordFreq) {
-            sortedWords.insert({pair.second, pair.first});
-        }
+// Bigram/trigram counts per rating bucket (sketch-bounded unless options.exact)
+void displayNGramFrequencies(ReviewNode* head, const NGramOptions& options, int limit) {
+    NGramAnalyzer analyzer(options);
+    for (ReviewNode* r = head; r; r = r->link) {
+        analyzer.addReview(r->review, r->rating);
+    }
 
-        cout << "\nWord frequencies in 1-star reviews (sorted by frequency):" << endl;
-        for (const auto& pair : sortedWords) {
-            cout << pair.second << ": " << pair.first << endl;
+    for (int rating = NGramAnalyzer::RATINGS; rating >= 1; --rating) {
+        vector<NGramCount> top = analyzer.top(rating, limit);
+        cout << "\nTop " << options.n << "-grams in " << rating << "-star reviews"
+             << (options.exact ? "" : " (approximate)") << ":" << endl;
+        if (top.empty()) cout << "None found." << endl;
+        for (const auto& entry : top) {
+            cout << entry.ngram << ": " << entry.count << endl;
         }
     }
 }
 
+// Review IDs are list positions; nodes already in the index are skipped,
+// so calling this after appending reviews indexes only the new ones
+void buildReviewTextIndex(ReviewNode* head, ReviewTextIndex& index) {
+    int position = 0;
+    for (ReviewNode* r = head; r; r = r->link, ++position) {
+        if (position < index.reviewCount()) continue;
+        index.addReview(r->review, r->rating, r->product_id);
+    }
+}
+
+void displayReviewSearch(ReviewNode* head, const ReviewTextIndex& index, const ReviewQuery& query) {
+    vector<uint32_t> ids = index.search(query);
+    OutputWriter out;
+
+    // IDs are ascending, so one walk down the list reaches every match
+    size_t next = 0;
+    uint32_t position = 0;
+    for (ReviewNode* r = head; r && next < ids.size(); r = r->link, ++position) {
+        if (position != ids[next]) continue;
+        out << "Customer ID: " << r->customer_id << ", Rating: " << r->rating << ", Review: " << r->review << '\n';
+        next++;
+    }
+    out << "Matching reviews: " << ids.size() << '\n';
+}
+
+// ---------------- Category Statistics ----------------
+
+void displayTransactionStats(const TransactionStats& stats) {
+    cout << "\n=== CATEGORY STATISTICS (approximate) ===" << endl;
+    for (const string& category : stats.categoryNames()) {
+        cout << category << ": " << stats.transactionCount(category) << " transactions, ~"
+             << fixed << setprecision(0) << stats.distinctCustomers(category) << " customers, price p50 $"
+             << setprecision(2) << stats.priceQuantile(category, 0.50)
+             << ", p95 $" << stats.priceQuantile(category, 0.95)
+             << ", p99 $" << stats.priceQuantile(category, 0.99) << endl;
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+}
+
 // Function to get node at position 'pos' in linked list
 TransactionNode* getNodeAtPosition(TransactionNode* head, int pos) {
     TransactionNode* current = head;
@@ -621,34 +967,19 @@ int getListLength(TransactionNode* head) {
 }
 
 
-void processElectronicsCreditCardPercentage(TransactionNode* head) {
-    if (!head) {
+// The cube is filled once by the loader, so this is two lookups
+void processElectronicsCreditCardPercentage(const TransactionCube& cube) {
+    if (cube.cellCount() == 0) {
         cout << "No transactions found." << endl;
         return;
     }
-
-    int totalElectronics = 0;
-    int creditCardElectronics = 0;
-    
-    // First, sort the list by category to optimize search
-    TransactionNode* sortedHead = mergeSort(head);
-
     cout << "\n=== ELECTRONICS CATEGORY PAYMENT ANALYSIS ===\n";
-   
-    // Binary Search
-    // Simply count all Electronics transactions with a single pass through the list
-    TransactionNode* current = sortedHead;
-    while (current) {
-        // Make sure to compare case-insensitively or exactly as stored
-        if (current->data.category == "Electronics") {
-            totalElectronics++;
-            if (current->data.paymentMethod == "Credit Card") {
-                creditCardElectronics++;
-            }
-        }
-        current = current->next;
-    }
 
+    int electronicsKey = globalStringPool().find("Electronics");
+    int creditCardKey = globalStringPool().find("Credit Card");
+    int totalElectronics = electronicsKey < 0 ? 0 : cube.cell(electronicsKey, TransactionCube::ANY).count;
+    int creditCardElectronics = (electronicsKey < 0 || creditCardKey < 0)
+                                    ? 0 : cube.cell(electronicsKey, creditCardKey).count;
 
     // Calculate percentage
     double percentage = (totalElectronics > 0) ? 
@@ -660,6 +991,442 @@ void processElectronicsCreditCardPercentage(TransactionNode* head) {
     cout << "Percentage of Electronics purchases made using Credit Card: " << fixed << setprecision(2) << percentage << "%" << endl;
 }
 
+// ---------------- Unrolled List Backend ----------------
+// Same workflow on UnrolledList blocks (unrolled_h_list.hpp): 64 records
+// per node, so walks run at close to array speed.
+
+TransactionList readTransactionList(const string& filename, int threads, TransactionCube* cube) {
+    TransactionList list;
+    vector<vector<Record>> chunks(1);
+    if (isColumnarFile(filename)) {
+        if (!readTransactionsColumnar(filename, chunks[0])) {
+            cerr << "Error: Could not read columnar transaction file." << endl;
+            return list;
+        }
+    } else if (!parallelParseCSV<Record>(filename, threads, parseTransactionRow, chunks)) {
+        cerr << "Error: Could not open transaction file." << endl;
+        return list;
+    }
+
+    if (cube) buildCubeFromChunks(chunks, *cube);
+    for (auto& chunk : chunks)
+        for (auto& record : chunk) list.push_back(move(record));
+    return list;
+}
+
+ReviewList readReviewList(const string& filename, int threads) {
+    ReviewList list;
+    vector<vector<ReviewNode>> chunks(1);
+    if (isColumnarFile(filename)) {
+        if (!readReviewsColumnar(filename, chunks[0])) {
+            cerr << "Error: Could not read columnar review file." << endl;
+            return list;
+        }
+    } else if (!parallelParseCSV<ReviewNode>(filename, threads, parseReviewRow, chunks)) {
+        cerr << "Error: Could not open review file." << endl;
+        return list;
+    }
+
+    for (auto& chunk : chunks)
+        for (auto& review : chunk) {
+            review.link = nullptr;
+            list.push_back(move(review));
+        }
+    return list;
+}
+
+// Keys are extracted once, the permutation is computed on them and the
+// records are moved a single time.
+void sortTransactions(TransactionList& list, SortMode mode) {
+    int n = list.size();
+    vector<int32_t> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+
+    if (mode == BY_CATEGORY) {
+        vector<string_view> categories;
+        for (const Record& r : list) categories.push_back(r.category);
+        order = stringSortOrder(n, [&](int i) { return categories[i]; });
+    } else {
+        vector<double> keys;
+        keys.reserve(n);
+        for (const Record& r : list) keys.push_back(mode == BY_DATE ? r.dateToInt() : r.price);
+        stable_sort(order.begin(), order.end(), [&](int32_t a, int32_t b) { return keys[a] < keys[b]; });
+    }
+    list.permute(order);
+}
+
+void displayTransactions(const TransactionList& list) {
+    OutputWriter out;
+    for (const Record& r : list) printTransaction(out, r);
+}
+
+void linearSearchByDate(const TransactionList& list, const string& targetDate) {
+    OutputWriter out;
+    bool found = false;
+    for (const Record& r : list) {
+        if (r.date == targetDate) {
+            printTransaction(out, r);
+            found = true;
+        }
+    }
+    if (!found) {
+        out << "No transactions found on the given date.\n";
+    }
+}
+
+// Needs the list sorted BY_DATE. Finds the first match by binary search
+// over the blocks, then prints forward while the date still matches.
+void binarySearchByDate(const TransactionList& list, const string& targetDate) {
+    OutputWriter out;
+    int target = dateToInt(targetDate);
+    int first = list.partitionPoint([&](const Record& r) { return r.dateToInt() < target; });
+
+    bool found = false;
+    for (auto it = list.iteratorAt(first); it != list.end() && it->date == targetDate; ++it) {
+        if (!found) {
+            out << "Transactions found on date " << targetDate << ":\n";
+            found = true;
+        }
+        printTransaction(out, *it);
+    }
+
+    if (!found) {
+        out << "No transactions found for the given date.\n";
+    }
+}
+
+int countReviews(const ReviewList& reviews) {
+    return reviews.size();
+}
+
+// Same rule as the node version: each customer keeps at most as many
+// reviews as they have transactions, earliest first. Survivors are packed
+// in place in one pass instead of unlinking nodes one by one.
+void filterReviews(ReviewList& reviews, const TransactionList& transactions) {
+    StringPool& pool = globalStringPool();
+    vector<int> transactionCounts(pool.size(), 0);
+    for (const Record& r : transactions) transactionCounts[r.customerID.handle()]++;
+
+    vector<int> reviewCounts(pool.size(), 0);
+    reviews.removeIf([&](const ReviewNode& r) {
+        int cid = r.customer_id.handle();
+        if (reviewCounts[cid] < transactionCounts[cid]) {
+            reviewCounts[cid]++;
+            return false;
+        }
+        return true;
+    });
+}
+
+// Longest first, equal lengths in reverse input order (as mergeSortByReviewLength)
+void sortByReviewLength(ReviewList& reviews) {
+    int n = reviews.size();
+    vector<int32_t> lengths;
+    lengths.reserve(n);
+    for (const ReviewNode& r : reviews) lengths.push_back((int32_t)r.review.length());
+
+    vector<int32_t> slots = countingSortSlots(n, [&](int i) { return lengths[i]; }, true, true);
+    vector<int32_t> order(n);
+    for (int i = 0; i < n; ++i) order[slots[i]] = i;
+    reviews.permute(order);
+}
+
+void displayReviews(const ReviewList& reviews) {
+    OutputWriter out;
+    for (const ReviewNode& r : reviews) printReview(out, r);
+}
+
+void displayWordFrequenciesInOneStarReviews(const ReviewList& reviews) {
+    unordered_map<string, int> wordFreq;
+    for (const ReviewNode& r : reviews) {
+        if (r.rating != 1) continue;
+        stringstream ss(r.review);
+        string word;
+        while (ss >> word) {
+            word = cleanWord(word);
+            if (!word.empty()) wordFreq[word]++;
+        }
+    }
+    printOneStarWordFrequencies(wordFreq);
+}
+
+void saveReviewsToCSV(const ReviewList& reviews, const string& filename) {
+    FILE* file = openReviewCSV(filename);
+    if (!file) return;
+
+    {
+        OutputWriter outFile(file);
+        outFile << "product_id,customer_id,rating,review\n";
+        for (const ReviewNode& r : reviews) writeReviewRow(outFile, r);
+    }
+
+    fclose(file);
+    cout << "\nFiltered reviews saved to '" << filename << "'" << endl;
+}
+
+// ---------------- B+ Tree Date Index ----------------
+
+// The sequence number is the row ID, so equal dates stay in list order
+TransactionTree buildTransactionTree(TransactionNode* head) {
+    TransactionTree tree;
+    vector<pair<DateSeqKey, int32_t>> entries;
+    for (TransactionNode* t = head; t; t = t->next) {
+        int32_t row = (int32_t)tree.rows.size();
+        tree.rows.push_back(t->data);
+        entries.push_back({DateSeqKey{t->data.dateToInt(), row}, row});
+    }
+    sort(entries.begin(), entries.end(),
+         [](const pair<DateSeqKey, int32_t>& a, const pair<DateSeqKey, int32_t>& b) { return a.first < b.first; });
+    tree.byDate.bulkLoad(entries);
+    return tree;
+}
+
+int insertTransaction(TransactionTree& tree, const Record& record) {
+    int32_t row = (int32_t)tree.rows.size();
+    tree.rows.push_back(record);
+    tree.byDate.insert(DateSeqKey{record.dateToInt(), row}, row);
+    return row;
+}
+
+bool eraseTransaction(TransactionTree& tree, int rowId) {
+    if (rowId < 0 || rowId >= (int)tree.rows.size()) return false;
+    return tree.byDate.erase(DateSeqKey{tree.rows[rowId].dateToInt(), rowId});
+}
+
+void displayTransactions(const TransactionTree& tree) {
+    OutputWriter out;
+    for (auto it = tree.byDate.begin(); it != tree.byDate.end(); ++it) printTransaction(out, tree.rows[it.value()]);
+}
+
+// One descent to the first entry of the day, then along the leaf chain
+void binarySearchByDate(const TransactionTree& tree, const string& targetDate) {
+    OutputWriter out;
+    int target = dateToInt(targetDate);
+    bool found = false;
+    tree.byDate.scan(DateSeqKey::first(target), DateSeqKey::last(target), [&](const DateSeqKey&, int32_t row) {
+        if (!found) {
+            out << "Transactions found on date " << targetDate << ":\n";
+            found = true;
+        }
+        printTransaction(out, tree.rows[row]);
+    });
+
+    if (!found) {
+        out << "No transactions found for the given date.\n";
+    }
+}
+
+void searchDateRange(const TransactionTree& tree, const string& fromDate, const string& toDate) {
+    OutputWriter out;
+    int count = 0;
+    tree.byDate.scan(DateSeqKey::first(dateToInt(fromDate)), DateSeqKey::last(dateToInt(toDate)),
+                     [&](const DateSeqKey&, int32_t row) {
+        if (count++ == 0) out << "Transactions from " << fromDate << " to " << toDate << ":\n";
+        printTransaction(out, tree.rows[row]);
+    });
+
+    if (count == 0) out << "No transactions found in the given date range.\n";
+    else out << "Total: " << count << " transactions\n";
+}
+
+// Copies the live rows into a new list in date order
+TransactionNode* toTransactionList(const TransactionTree& tree) {
+    TransactionNode* head = nullptr;
+    TransactionNode** tail = &head;
+    for (auto it = tree.byDate.begin(); it != tree.byDate.end(); ++it) {
+        *tail = createTransactionNode(tree.rows[it.value()]);
+        tail = &(*tail)->next;
+    }
+    return head;
+}
+
+// ---------------- Q3 Workflow ----------------
+
+static void countWords(const string& review, unordered_map<string, int>& wordFreq) {
+    stringstream ss(review);
+    string word;
+    while (ss >> word) {
+        word = cleanWord(word);
+        if (!word.empty()) wordFreq[word]++;
+    }
+}
+
+// Load, filter, copy the 1-star reviews, sort them by length, count words:
+// each step finishes before the next starts.
+Q3Result runQ3Sequential(const string& transactionFile, const string& reviewFile) {
+    Q3Result result;
+    result.transactions = readTransactionCSV(transactionFile);
+
+    AsyncLineReader reader(reviewFile);
+    ReviewNode** reviewTail = &result.filteredReviews;
+    string_view line;
+    reader.nextRecord(line); // skip header
+    ReviewNode parsed;
+    while (reader.nextRecord(line)) {
+        if (!parseReviewRow(line, parsed)) continue;
+        *reviewTail = createReviewNode(parsed.product_id, parsed.customer_id, parsed.rating, parsed.review);
+        reviewTail = &(*reviewTail)->link;
+    }
+
+    filterReviews(&result.filteredReviews, result.transactions);
+
+    ReviewNode** tail = &result.oneStarReviews;
+    for (ReviewNode* r = result.filteredReviews; r; r = r->link) {
+        if (r->rating != 1) continue;
+        *tail = createReviewNode(r->product_id, r->customer_id, r->rating, r->review);
+        tail = &(*tail)->link;
+    }
+    result.oneStarReviews = bucketSortByReviewLength(result.oneStarReviews);
+
+    for (ReviewNode* r = result.oneStarReviews; r; r = r->link) countWords(r->review, result.wordFreq);
+    return result;
+}
+
+// Pipeline source stage: parses `filename` (or reads it whole if it is
+// columnar) and pushes batches of batchSize rows, then closes the queue
+template <typename Row, typename ParseRow, typename ReadColumnar>
+static void produceBatches(const string& filename, SpscQueue<vector<Row>>& queue, int batchSize,
+                           ParseRow parseRow, ReadColumnar readColumnar) {
+    vector<Row> batch;
+    batch.reserve(batchSize);
+    auto add = [&](Row& row) {
+        batch.push_back(move(row));
+        if ((int)batch.size() < batchSize) return;
+        queue.push(move(batch));
+        batch = vector<Row>();
+        batch.reserve(batchSize);
+    };
+
+    if (isColumnarFile(filename)) {
+        vector<Row> rows;
+        readColumnar(filename, rows);
+        for (Row& row : rows) add(row);
+    } else {
+        AsyncLineReader reader(filename);
+        string_view line;
+        reader.nextRecord(line); // skip header
+        Row row;
+        while (reader.nextRecord(line)) {
+            if (parseRow(line, row)) add(row);
+        }
+    }
+    if (!batch.empty()) queue.push(move(batch));
+    queue.close();
+}
+
+// Four stages joined by bounded SPSC queues of row batches:
+//
+//   transaction parser --+
+//                        +--> filter (this thread) --> 1-star tokenizer
+//   review parser -------+
+//
+// Both files are parsed at the same time. The filter needs every
+// customer's transaction count before it can decide on a review, so it
+// drains the transaction queue first; review batches wait in their own
+// queue meanwhile. It is the only stage that interns strings (the pool is
+// not thread-safe). Word counts do not depend on order, so 1-star
+// reviews are tokenized as soon as they pass the filter. Only the final
+// sort by length waits for the whole stream.
+Q3Result runQ3Pipeline(const string& transactionFile, const string& reviewFile, int batchSize) {
+    if (batchSize < 1) batchSize = 1024;
+    const size_t QUEUE_BATCHES = 16;
+    SpscQueue<vector<Record>> transactionBatches(QUEUE_BATCHES);
+    SpscQueue<vector<ReviewNode>> reviewBatches(QUEUE_BATCHES);
+    SpscQueue<vector<ReviewNode*>> oneStarBatches(QUEUE_BATCHES);
+
+    thread transactionParser([&] {
+        produceBatches(transactionFile, transactionBatches, batchSize, parseTransactionRow,
+                       [](const string& f, vector<Record>& rows) { readTransactionsColumnar(f, rows); });
+    });
+    thread reviewParser([&] {
+        produceBatches(reviewFile, reviewBatches, batchSize, parseReviewRow,
+                       [](const string& f, vector<ReviewNode>& rows) { readReviewsColumnar(f, rows); });
+    });
+
+    vector<ReviewNode*> oneStar;
+    unordered_map<string, int> wordFreq;
+    thread tokenizer([&] {
+        vector<ReviewNode*> batch;
+        while (oneStarBatches.pop(batch)) {
+            for (ReviewNode* r : batch) {
+                countWords(r->review, wordFreq);
+                oneStar.push_back(r);
+            }
+        }
+    });
+
+    // Filter stage
+    Q3Result result;
+    StringPool& pool = globalStringPool();
+    vector<int> transactionCounts;
+    TransactionNode** transactionTail = &result.transactions;
+    vector<Record> transactions;
+    while (transactionBatches.pop(transactions)) {
+        for (Record& record : transactions) {
+            *transactionTail = createTransactionNode(move(record));
+            int key = (*transactionTail)->data.customerID.handle();
+            if (key >= (int)transactionCounts.size()) transactionCounts.resize(pool.size(), 0);
+            transactionCounts[key]++;
+            transactionTail = &(*transactionTail)->next;
+        }
+    }
+
+    // Same rule as filterReviews: a customer keeps at most one review per transaction
+    vector<int> reviewCounts(transactionCounts.size(), 0);
+    ReviewNode** reviewTail = &result.filteredReviews;
+    vector<ReviewNode> reviews;
+    while (reviewBatches.pop(reviews)) {
+        vector<ReviewNode*> passed;
+        for (ReviewNode& review : reviews) {
+            int key = review.customer_id.handle();
+            if (key >= (int)transactionCounts.size() || reviewCounts[key] >= transactionCounts[key]) continue;
+            reviewCounts[key]++;
+
+            ReviewNode* node = createReviewNode(review.product_id, review.customer_id, review.rating, review.review);
+            *reviewTail = node;
+            reviewTail = &node->link;
+            if (node->rating == 1)
+                passed.push_back(createReviewNode(node->product_id, node->customer_id, node->rating, node->review));
+        }
+        if (!passed.empty()) oneStarBatches.push(move(passed));
+    }
+    oneStarBatches.close();
+
+    transactionParser.join();
+    reviewParser.join();
+    tokenizer.join();
+
+    ReviewNode** oneStarTail = &result.oneStarReviews;
+    for (ReviewNode* r : oneStar) {
+        *oneStarTail = r;
+        oneStarTail = &r->link;
+    }
+    result.oneStarReviews = bucketSortByReviewLength(result.oneStarReviews);
+    result.wordFreq = move(wordFreq);
+    return result;
+}
+
+// Words with equal counts are listed alphabetically, so the report is the
+// same whichever order the words were counted in.
+void displayQ3Result(const Q3Result& result) {
+    cout << "\n=== Sorted 1-Star Reviews ===\n";
+    displayReviews(result.oneStarReviews);
+    cout << "\nTotal number of 1-star reviews: " << countReviews(result.oneStarReviews) << endl;
+
+    vector<pair<string, int>> words(result.wordFreq.begin(), result.wordFreq.end());
+    sort(words.begin(), words.end(), [](const pair<string, int>& a, const pair<string, int>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    if (words.empty()) {
+        cout << "\nNo 1-star reviews found." << endl;
+        return;
+    }
+    OutputWriter out;
+    out << "\nWord Frequencies in 1-Star Reviews (sorted by frequency):\n";
+    for (const auto& [word, count] : words) {
+        out << word << ": " << count << "\n";
+    }
+}
 
 
 
@@ -675,6 +1442,8 @@ void processElectronicsCreditCardPercentage(TransactionNode* head) {
 
 //     // === SORT METHOD ===
 //     transactionHead = mergeSort(transactionHead);
+//     // or keep a B+ tree on (date, sequence) instead of sorting the list:
+//     // TransactionTree tree = buildTransactionTree(transactionHead);
 
 //     string targetDate;
 //     cout << "Enter date to search (format DD/MM/YYYY): ";
@@ -683,6 +1452,7 @@ void processElectronicsCreditCardPercentage(TransactionNode* head) {
 //     auto start = high_resolution_clock::now();
 
 //     // === SEARCH METHOD ===
+//     // binarySearchByDate(tree, targetDate);   // one descent, then the leaf chain
 //     // jumpSearchByDate(transactionHead, targetDate);
 //     // interpolationSearchByDate(transactionHead, targetDate);
 //     // linearSearchByDate(transactionHead, targetDate);
@@ -747,7 +1517,9 @@ void processElectronicsCreditCardPercentage(TransactionNode* head) {
 
 // // Q2 FULL
 // int main() {
-//     TransactionNode* transactions = readTransactionCSV("transactions_cleaned.csv");
+//     // The cube is filled while loading, so the query itself is two lookups
+//     TransactionCube cube;
+//     TransactionNode* transactions = readTransactionCSVParallel("transactions_cleaned.csv", 1, nullptr, &cube);
 //     if (!transactions) {
 //         cerr << "Failed to load transaction data." << endl;
 //         return 1;
@@ -755,7 +1527,7 @@ void processElectronicsCreditCardPercentage(TransactionNode* head) {
 
 //     auto start = high_resolution_clock::now();
     
-//     processElectronicsCreditCardPercentage(transactions);
+//     processElectronicsCreditCardPercentage(cube);
     
 //     auto end = high_resolution_clock::now();
 //     cout << "\nExecution Time: " << duration_cast<milliseconds>(end - start).count() << " ms\n";
@@ -773,6 +1545,103 @@ void processElectronicsCreditCardPercentage(TransactionNode* head) {
 
 
 
+// // Q3 UNROLLED
+// int main() {
+//     auto start = high_resolution_clock::now();
+
+//     // Same steps as Q3 FULL on the unrolled list backend
+//     TransactionList transactions = readTransactionList("transactions_cleaned.csv");
+//     ReviewList reviews = readReviewList("reviews_cleaned.csv");
+//     if (transactions.empty() || reviews.empty()) return 1;
+
+//     filterReviews(reviews, transactions);
+//     reviews.removeIf([](const ReviewNode& r) { return r.rating != 1; });
+//     sortByReviewLength(reviews);
+
+//     cout << "\n=== Sorted 1-Star Reviews ===\n";
+//     displayReviews(reviews);
+//     cout << "\nTotal number of 1-star reviews: " << countReviews(reviews) << endl;
+//     displayWordFrequenciesInOneStarReviews(reviews);
+
+//     auto end = high_resolution_clock::now();
+//     cout << "\nExecution Time: " << duration_cast<milliseconds>(end - start).count() << " ms\n";
+//     return 0;
+// }
+
+
+
+// // UNROLLED CHECK
+// int main() {
+//     // Random push_back/insert/erase/removeIf on a small-block list, checked
+//     // against a vector after every step. Small blocks make insert split and
+//     // erase/removeIf repack often.
+//     unsigned seed = 7;
+//     auto next = [&seed](int bound) {
+//         seed = seed * 1103515245u + 12345u;
+//         return (int)((seed >> 8) % (unsigned)bound);
+//     };
+
+//     for (int round = 0; round < 2000; ++round) {
+//         UnrolledList<string, 8> list;
+//         vector<string> expected;
+//         int steps = next(200);
+//         for (int step = 0; step < steps; ++step) {
+//             string value = to_string(next(1000));
+//             int op = expected.empty() ? 0 : next(4);
+//             if (op == 0) {
+//                 list.push_back(value);
+//                 expected.push_back(value);
+//             } else if (op == 1) {
+//                 int pos = next((int)expected.size() + 1);
+//                 list.insert(pos, value);
+//                 expected.insert(expected.begin() + pos, value);
+//             } else if (op == 2) {
+//                 int pos = next((int)expected.size());
+//                 list.erase(pos);
+//                 expected.erase(expected.begin() + pos);
+//             } else {
+//                 // Digit 1-7 drops matching items; 8 and 9 never match, which
+//                 // still repacks blocks left partly full by insert/erase
+//                 char digit = (char)('1' + next(9));
+//                 auto matches = [digit](const string& s) { return s.back() == digit && digit <= '7'; };
+//                 list.removeIf(matches);
+//                 expected.erase(remove_if(expected.begin(), expected.end(), matches), expected.end());
+//             }
+
+//             vector<string> actual(list.begin(), list.end());
+//             if (list.size() != (int)expected.size() || actual != expected) {
+//                 cout << "FAIL: round " << round << ", step " << step << "\n";
+//                 return 1;
+//             }
+//         }
+//     }
+//     cout << "All unrolled list checks passed\n";
+//     return 0;
+// }
+
+
+
+// // Q3 PIPELINE
+// int main() {
+//     // Today's step-by-step run, then the staged pipeline, on the same files
+//     auto start = high_resolution_clock::now();
+//     Q3Result sequential = runQ3Sequential("transactions_cleaned.csv", "reviews_cleaned.csv");
+//     auto middle = high_resolution_clock::now();
+//     Q3Result pipelined = runQ3Pipeline("transactions_cleaned.csv", "reviews_cleaned.csv");
+//     auto end = high_resolution_clock::now();
+
+//     displayQ3Result(pipelined);
+
+//     cout << "\nSequential: " << duration_cast<milliseconds>(middle - start).count() << " ms\n";
+//     cout << "Pipeline: " << duration_cast<milliseconds>(end - middle).count() << " ms\n";
+//     cout << "Same 1-star reviews and word counts: "
+//          << (countReviews(sequential.oneStarReviews) == countReviews(pipelined.oneStarReviews) &&
+//              sequential.wordFreq == pipelined.wordFreq ? "yes" : "no") << endl;
+//     return 0;
+// }
+
+
+
 // Q3 FULL
 int main() {
     // Read transaction data
@@ -783,29 +1652,25 @@ int main() {
     }
 
     // Read review data
-    FILE* file = fopen("reviews_cleaned.csv", "r");
-    if (!file) {
+    AsyncLineReader reader("reviews_cleaned.csv");
+    if (!reader.is_open()) {
         cout << "Failed to open review file." << endl;
         return 1;
     }
 
     ReviewNode* reviewHead = nullptr;
-    char line[512];
-    fgets(line, sizeof(line), file); // skip header
-
-    while (fgets(line, sizeof(line), file)) {
-        char* product_id = strtok(line, ",");
-        char* customer_id = strtok(NULL, ",");
-        char* rating_str = strtok(NULL, ",");
-        char* review = strtok(NULL, "\n");
-
-        if (product_id && customer_id && rating_str && review) {
-            int rating = atoi(rating_str);
-            ReviewNode* newNode = createReviewNode(product_id, customer_id, rating, review);
-            appendReviewNode(&reviewHead, newNode);
+    ReviewNode** reviewTail = &reviewHead;
+    string_view line;
+    reader.nextRecord(line); // skip header
+
+    ReviewNode parsed;
+    while (reader.nextRecord(line)) {
+        if (parseReviewRow(line, parsed)) {
+            ReviewNode* newNode = createReviewNode(parsed.product_id, parsed.customer_id, parsed.rating, parsed.review);
+            *reviewTail = newNode;
+            reviewTail = &newNode->link;
         }
     }
-    fclose(file);
 
     // Filter invalid reviews based on transactions
     filterReviews(&reviewHead, transactionHead);
@@ -821,8 +1686,8 @@ int main() {
         }
     }
 
-    // Step 1: Sort 1-star reviews by review length using merge sort
-    oneStarHead = mergeSortByReviewLength(oneStarHead);
+    // Step 1: Sort 1-star reviews by review length (counting sort, same order as mergeSortByReviewLength)
+    oneStarHead = bucketSortByReviewLength(oneStarHead);
 
     // Step 2: Display sorted 1-star reviews (optional)
     cout << "\n=== Sorted 1-Star Reviews ===\n";
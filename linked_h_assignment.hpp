@@ -2,25 +2,56 @@
 #define LINKED_ASSIGNMENT_HPP
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+#include <functional>
+#include "intern_h_pool.hpp"
+#include "join_h_customers.hpp"
+#include "text_h_index.hpp"
+#include "ngram_h_sketch.hpp"
+#include "stats_h_sketches.hpp"
+#include "cube_h_transactions.hpp"
+#include "bucket_h_sort.hpp"
+#include "string_h_sort.hpp"
+#include "columnar_h_store.hpp"
+#include "unrolled_h_list.hpp"
+#include "bplus_h_tree.hpp"
+#include "pipeline_h_queue.hpp"
+#include "output_h_writer.hpp"
 
 using namespace std;
 
 // ---------------- Structs ----------------
 
+// "DD/MM/YYYY" (any zero padding) -> YYYYMMDD; missing parts count as 0
+inline int dateKey(string_view date) {
+    int parts[3] = {0, 0, 0};
+    size_t i = 0;
+    for (int& part : parts) {
+        while (i < date.size() && date[i] >= '0' && date[i] <= '9') part = part * 10 + (date[i++] - '0');
+        if (i < date.size() && date[i] == '/') ++i;
+    }
+    return parts[2] * 10000 + parts[1] * 100 + parts[0];
+}
+
+// Every text field except review bodies is an InternedString: 4 bytes of
+// handle per field, characters shared through globalStringPool().
 struct Record {
-    string customerID;
-    string product;
-    string category;
+    InternedString customerID;
+    InternedString product;
+    InternedString category;
     double price;
-    string date;
-    string paymentMethod;
+    InternedString date;
+    InternedString paymentMethod;
 
-    int dateToInt() const {
-        int month, day, year;
-        sscanf(date.c_str(), "%d/%d/%d", &day, &month, &year);
-        return year * 10000 + month * 100 + day;
-    }
+    int dateToInt() const { return dateKey(date); }
+};
+
+enum SortMode {
+    BY_DATE,
+    BY_CATEGORY,
+    BY_PRICE
 };
 
 struct TransactionNode {
@@ -31,8 +62,8 @@ struct TransactionNode {
 };
 
 struct ReviewNode {
-    string product_id;
-    string customer_id;
+    InternedString product_id;
+    InternedString customer_id;
     int rating;
     string review;
     ReviewNode* link;
@@ -43,6 +74,9 @@ struct ReviewNode {
 TransactionNode* createTransactionNode(const Record& record);
 void appendTransactionNode(TransactionNode*& head, TransactionNode* newNode);
 TransactionNode* readTransactionCSV(const string& filename);
+bool parseTransactionRow(string_view line, Record& record);
+TransactionNode* readTransactionCSVParallel(const string& filename, int threads, TransactionStats* stats = nullptr,
+                                            TransactionCube* cube = nullptr);
 
 // ---------------- Sorting Algorithms ----------------
 
@@ -51,13 +85,19 @@ TransactionNode* selectionSort(TransactionNode* head);
 TransactionNode* insertionSort(TransactionNode*& head);
 TransactionNode* merge(TransactionNode* left, TransactionNode* right);
 TransactionNode* mergeSort(TransactionNode* head);
+TransactionNode* sortByText(TransactionNode* head, InternedString Record::*field);   // e.g. &Record::product, stable
+
+// ---------------- Top-K Selection ----------------
+
+bool compareRecords(const Record& a, const Record& b, SortMode mode);
+TransactionNode* topK(TransactionNode* head, int k, SortMode mode);
 
 // ---------------- Searching Algorithms ----------------
 
 void linearSearchByDate(TransactionNode* head, const string& targetDate);
 TransactionNode* binarySearch(TransactionNode* head, const string& targetDate);
 void binarySearchByDate(TransactionNode* head, const string& targetDate);
-int dateToInt(const string& date);
+int dateToInt(string_view date);
 void jumpSearchByDate(TransactionNode* head, const string& targetDate);
 void interpolationSearchByDate(TransactionNode* head, const string& targetDate);
 
@@ -66,22 +106,102 @@ void interpolationSearchByDate(TransactionNode* head, const string& targetDate);
 void displayTransactions(TransactionNode* head);
 TransactionNode* getNodeAtPosition(TransactionNode* head, int pos);
 int getListLength(TransactionNode* head);
-void processElectronicsCreditCardPercentage(TransactionNode* head);
+void processElectronicsCreditCardPercentage(const TransactionCube& cube);   // cube from the loader
+void displayTransactionStats(const TransactionStats& stats);
 
 // ---------------- Review Functions ----------------
 
-ReviewNode* createReviewNode(const string& product_id, const string& customer_id, int rating, const string& review);
+ReviewNode* createReviewNode(string_view product_id, string_view customer_id, int rating, const string& review);
 void appendReviewNode(ReviewNode** head, ReviewNode* node);
 void displayReviews(ReviewNode* head);
+bool parseReviewRow(string_view line, ReviewNode& review);
+ReviewNode* readReviewCSVParallel(const string& filename, int threads);
 int countReviews(ReviewNode* head);
 void filterReviews(ReviewNode** reviewHeadRef, TransactionNode* transactionHead, bool debug);
 void saveReviewsToCSV(ReviewNode* head, const string& filename);
 
+// ---------------- Customer Join ----------------
+// Row IDs are list positions; pairs are (review position, transaction position).
+
+vector<JoinPair> joinReviewsToTransactions(ReviewNode* reviews, TransactionNode* transactions, int threads);
+void forEachReviewTransaction(ReviewNode* reviews, TransactionNode* transactions,
+                              const function<void(const ReviewNode&, const Record&)>& fn);
+
+// ---------------- Columnar Storage ----------------
+// See columnar_h_store.hpp. readTransactionCSV / readTransactionCSVParallel /
+// readReviewCSVParallel also accept columnar files.
+
+bool saveTransactionsColumnar(TransactionNode* head, const string& filename);
+bool saveReviewsColumnar(ReviewNode* head, const string& filename);
+TransactionNode* readTransactionColumnar(const string& filename,
+                                         const TransactionPredicate& pred = TransactionPredicate(),
+                                         ColumnarScanInfo* scan = nullptr);
+ReviewNode* readReviewColumnar(const string& filename, const ReviewPredicate& pred = ReviewPredicate(),
+                               ColumnarScanInfo* scan = nullptr);
+
 // ---------------- Review Analysis ----------------
 
 string cleanWord(const string& word);
 ReviewNode* mergeByReviewLength(ReviewNode* a, ReviewNode* b);
 ReviewNode* mergeSortByReviewLength(ReviewNode* head);
+ReviewNode* bucketSortByReviewLength(ReviewNode* head);   // same order as mergeSortByReviewLength
+ReviewNode* bucketSortReviews(ReviewNode* head, ReviewSortKey key, bool descending);
 void displayWordFrequenciesInOneStarReviews(ReviewNode* head);
+void displayNGramFrequencies(ReviewNode* head, const NGramOptions& options, int limit);
+void buildReviewTextIndex(ReviewNode* head, ReviewTextIndex& index);
+void displayReviewSearch(ReviewNode* head, const ReviewTextIndex& index, const ReviewQuery& query);
+
+// ---------------- Unrolled List Backend ----------------
+// Blocks of 64 records per node (see unrolled_h_list.hpp); ReviewNode::link is unused.
+
+using TransactionList = UnrolledList<Record>;
+using ReviewList = UnrolledList<ReviewNode>;
+
+TransactionList readTransactionList(const string& filename, int threads = 1, TransactionCube* cube = nullptr);
+ReviewList readReviewList(const string& filename, int threads = 1);
+void sortTransactions(TransactionList& list, SortMode mode);   // stable
+void displayTransactions(const TransactionList& list);
+void linearSearchByDate(const TransactionList& list, const string& targetDate);
+void binarySearchByDate(const TransactionList& list, const string& targetDate);   // list sorted BY_DATE
+int countReviews(const ReviewList& reviews);
+void filterReviews(ReviewList& reviews, const TransactionList& transactions);
+void sortByReviewLength(ReviewList& reviews);   // same order as mergeSortByReviewLength
+void displayReviews(const ReviewList& reviews);
+void displayWordFrequenciesInOneStarReviews(const ReviewList& reviews);
+void saveReviewsToCSV(const ReviewList& reviews, const string& filename);
+
+// ---------------- B+ Tree Date Index ----------------
+// Transactions kept ordered by (date, insertion sequence) while inserting
+// and erasing; see bplus_h_tree.hpp. Row IDs index `rows`; an erased row
+// stays in `rows` but leaves the tree.
+
+struct TransactionTree {
+    vector<Record> rows;
+    BPlusTree<DateSeqKey, int32_t> byDate;
+};
+
+TransactionTree buildTransactionTree(TransactionNode* head);   // bulk load
+int insertTransaction(TransactionTree& tree, const Record& record);   // returns the row ID
+bool eraseTransaction(TransactionTree& tree, int rowId);
+void displayTransactions(const TransactionTree& tree);   // date order
+void binarySearchByDate(const TransactionTree& tree, const string& targetDate);
+void searchDateRange(const TransactionTree& tree, const string& fromDate, const string& toDate);   // inclusive
+TransactionNode* toTransactionList(const TransactionTree& tree);
+
+// ---------------- Q3 Workflow ----------------
+// Load both files, filter reviews against transactions, sort the 1-star
+// reviews by length and count their words. runQ3Pipeline runs the steps as
+// concurrent stages (see pipeline_h_queue.hpp); the results are the same.
+
+struct Q3Result {
+    TransactionNode* transactions = nullptr;
+    ReviewNode* filteredReviews = nullptr;
+    ReviewNode* oneStarReviews = nullptr;   // longest first, as in Q3 FULL
+    unordered_map<string, int> wordFreq;    // over the 1-star reviews
+};
+
+Q3Result runQ3Sequential(const string& transactionFile, const string& reviewFile);
+Q3Result runQ3Pipeline(const string& transactionFile, const string& reviewFile, int batchSize = 1024);
+void displayQ3Result(const Q3Result& result);
 
 #endif // LINKED_ASSIGNMENT_HPP
@@ -0,0 +1,190 @@
+#ifndef NGRAM_SKETCH_HPP
+#define NGRAM_SKETCH_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include "text_h_index.hpp"
+
+using namespace std;
+
+// ---------------- N-grams ----------------
+// Consecutive runs of n terms (see forEachTerm), joined by single spaces.
+// n-grams never cross review boundaries.
+
+template <typename Fn>
+void forEachNGram(string_view text, int n, Fn fn) {
+    vector<string> terms;
+    forEachTerm(text, [&](const string& term) { terms.push_back(term); });
+    string gram;
+    for (int i = 0; i + n <= (int)terms.size(); ++i) {
+        gram = terms[i];
+        for (int k = 1; k < n; ++k) gram += ' ' + terms[i + k];
+        fn(gram);
+    }
+}
+
+// ---------------- Count-Min Sketch ----------------
+// depth rows of width counters; an item's estimate is the minimum of its
+// counters, which never undercounts. Hashing is FNV-1a with a per-row seed,
+// so sketches are reproducible across runs and platforms.
+
+class CountMinSketch {
+public:
+    CountMinSketch(int width = 1 << 14, int depth = 4)
+        : width(width), depth(depth), counters((size_t)width * depth, 0) {}
+
+    // Adds `count` and returns the new estimate.
+    long long add(string_view item, long long count = 1) {
+        long long estimate = -1;
+        for (int row = 0; row < depth; ++row) {
+            long long& c = counters[(size_t)row * width + slot(item, row)];
+            c += count;
+            if (estimate < 0 || c < estimate) estimate = c;
+        }
+        return estimate;
+    }
+
+    long long estimate(string_view item) const {
+        long long estimate = -1;
+        for (int row = 0; row < depth; ++row) {
+            long long c = counters[(size_t)row * width + slot(item, row)];
+            if (estimate < 0 || c < estimate) estimate = c;
+        }
+        return estimate;
+    }
+
+    size_t memoryBytes() const { return counters.size() * sizeof(long long); }
+
+private:
+    int width;
+    int depth;
+    vector<long long> counters;
+
+    size_t slot(string_view item, int row) const {
+        uint64_t h = 1469598103934665603ULL ^ ((uint64_t)(row + 1) * 0x9E3779B97F4A7C15ULL);
+        for (char c : item) {
+            h ^= (unsigned char)c;
+            h *= 1099511628211ULL;
+        }
+        h ^= h >> 29;           // fold the high bits in before the modulo
+        return (size_t)(h % (uint64_t)width);
+    }
+};
+
+// ---------------- Space-Saving Heavy Hitters ----------------
+// Tracks at most `capacity` items. A new item evicts the smallest counter
+// and inherits its count, so counts overestimate by at most that minimum.
+// While fewer than `capacity` distinct items have been seen it is exact.
+
+class SpaceSaving {
+public:
+    explicit SpaceSaving(int capacity = 1000) : capacity(capacity) {}
+
+    void add(const string& item, long long count = 1) {
+        auto it = counts.find(item);
+        if (it != counts.end()) {
+            byCount.erase({it->second, item});
+            it->second += count;
+            byCount.insert({it->second, item});
+            return;
+        }
+        long long base = 0;
+        if ((int)counts.size() >= capacity) {
+            auto smallest = byCount.begin();
+            base = smallest->first;
+            counts.erase(smallest->second);
+            byCount.erase(smallest);
+        }
+        counts[item] = base + count;
+        byCount.insert({base + count, item});
+    }
+
+    const unordered_map<string, long long>& items() const { return counts; }
+
+private:
+    int capacity;
+    unordered_map<string, long long> counts;
+    set<pair<long long, string>> byCount;
+};
+
+// ---------------- N-gram Frequencies per Rating ----------------
+
+struct NGramCount {
+    string ngram;
+    long long count;
+};
+
+struct NGramOptions {
+    int n = 2;                  // 1 = words, 2 = bigrams, 3 = trigrams
+    bool exact = false;         // exact hash map instead of the sketch
+    int sketchWidth = 1 << 14;  // Count-Min counters per row
+    int sketchDepth = 4;
+    int heavyHitters = 1000;    // Space-Saving capacity per rating
+};
+
+// Ratings 1-5 are counted separately. In sketch mode memory is fixed by the
+// options regardless of input size; reported counts are the smaller of the
+// Space-Saving and Count-Min estimates (both only ever overcount), so they
+// equal the exact counts once the sketch has no collisions and the heavy
+// hitter table holds every distinct n-gram.
+class NGramAnalyzer {
+public:
+    static const int RATINGS = 5;
+
+    explicit NGramAnalyzer(const NGramOptions& options = NGramOptions()) : options(options) {
+        for (int r = 0; r < RATINGS; ++r) {
+            if (options.exact) {
+                exactCounts.emplace_back();
+            } else {
+                sketches.emplace_back(options.sketchWidth, options.sketchDepth);
+                heavy.emplace_back(options.heavyHitters);
+            }
+        }
+    }
+
+    void addReview(string_view text, int rating) {
+        if (rating < 1 || rating > RATINGS) return;
+        int bucket = rating - 1;
+        forEachNGram(text, options.n, [&](const string& gram) {
+            if (options.exact) {
+                exactCounts[bucket][gram]++;
+            } else {
+                sketches[bucket].add(gram);
+                heavy[bucket].add(gram);
+            }
+        });
+    }
+
+    // Most frequent n-grams for one rating, by count then alphabetically.
+    vector<NGramCount> top(int rating, int limit) const {
+        vector<NGramCount> result;
+        if (rating < 1 || rating > RATINGS) return result;
+        int bucket = rating - 1;
+        if (options.exact) {
+            for (const auto& entry : exactCounts[bucket]) result.push_back({entry.first, entry.second});
+        } else {
+            for (const auto& entry : heavy[bucket].items()) {
+                long long count = min(entry.second, sketches[bucket].estimate(entry.first));
+                result.push_back({entry.first, count});
+            }
+        }
+        sort(result.begin(), result.end(), [](const NGramCount& a, const NGramCount& b) {
+            return a.count != b.count ? a.count > b.count : a.ngram < b.ngram;
+        });
+        if (limit >= 0 && (int)result.size() > limit) result.resize(limit);
+        return result;
+    }
+
+private:
+    NGramOptions options;
+    vector<unordered_map<string, long long>> exactCounts;
+    vector<CountMinSketch> sketches;
+    vector<SpaceSaving> heavy;
+};
+
+#endif // NGRAM_SKETCH_HPP
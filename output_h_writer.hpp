@@ -0,0 +1,164 @@
+#ifndef OUTPUT_WRITER_HPP
+#define OUTPUT_WRITER_HPP
+
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+using namespace std;
+
+// ---------------- Buffered Output Writer ----------------
+// Formats into one large buffer and hands it to stdio in a few big fwrite
+// calls instead of one stream insertion per field. Numbers go through
+// std::to_chars; doubles follow the float format and precision of a
+// reference stream (cout unless told otherwise), so the bytes are the same
+// as printing with `cout << value` under the same settings.
+// On POSIX a string larger than half the buffer is written together with
+// the pending buffer in a single writev, without being copied.
+// Writing to stdout interleaves correctly with cout as long as cout stays
+// synced with stdio (the default); the writer flushes on destruction.
+
+class OutputWriter {
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;     // 1 MiB
+
+    explicit OutputWriter(FILE* out = stdout, size_t capacity = BUFFER_SIZE)
+        : out(out), buffer(capacity > 64 ? capacity : 64) {
+        if (out == stdout) cout.flush();
+        formatLike(cout);
+    }
+
+    ~OutputWriter() { flush(); }
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    // Doubles are formatted as `stream << value` would (floatfield + precision).
+    void formatLike(const ios_base& stream) {
+        floatField = stream.flags() & ios_base::floatfield;
+        precision = (int)stream.precision();
+    }
+
+    OutputWriter& operator<<(string_view s) {
+        if (s.size() > buffer.size() - used) {
+            if (s.size() >= buffer.size() / 2) {
+                writeDirect(s);
+                return *this;
+            }
+            flush();
+        }
+        memcpy(buffer.data() + used, s.data(), s.size());
+        used += s.size();
+        return *this;
+    }
+
+    OutputWriter& operator<<(const char* s) { return *this << string_view(s); }
+    OutputWriter& operator<<(const string& s) { return *this << string_view(s); }
+
+    OutputWriter& operator<<(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+        return *this;
+    }
+
+    OutputWriter& operator<<(int v) { return writeNumber(v); }
+    OutputWriter& operator<<(long v) { return writeNumber(v); }
+    OutputWriter& operator<<(long long v) { return writeNumber(v); }
+    OutputWriter& operator<<(unsigned v) { return writeNumber(v); }
+    OutputWriter& operator<<(unsigned long v) { return writeNumber(v); }
+    OutputWriter& operator<<(unsigned long long v) { return writeNumber(v); }
+
+    OutputWriter& operator<<(double v) {
+        reserve(NUMBER_ROOM);
+        char* first = buffer.data() + used;
+        char* last = buffer.data() + buffer.size();
+        to_chars_result r;
+        if (floatField == ios_base::fixed) r = to_chars(first, last, v, chars_format::fixed, precision);
+        else if (floatField == ios_base::scientific) r = to_chars(first, last, v, chars_format::scientific, precision);
+        else if (floatField == ios_base::fmtflags()) r = to_chars(first, last, v, chars_format::general, precision);
+        else r.ec = errc::not_supported;    // hexfloat: leave it to snprintf
+        if (r.ec != errc()) {
+            // Hexfloat, or a fixed value too long for the reserved room
+            bool fixed = floatField == ios_base::fixed;
+            int n = fixed ? snprintf(nullptr, 0, "%.*f", precision, v) : snprintf(nullptr, 0, "%a", v);
+            if (n <= 0) return *this;
+            string tmp(n, '\0');
+            if (fixed) snprintf(&tmp[0], n + 1, "%.*f", precision, v);
+            else snprintf(&tmp[0], n + 1, "%a", v);
+            return *this << string_view(tmp);
+        }
+        used = r.ptr - buffer.data();
+        return *this;
+    }
+
+    void flush() {
+        if (used) {
+            if (fwrite(buffer.data(), 1, used, out) != used) failed = true;
+            used = 0;
+        }
+        fflush(out);
+    }
+
+    bool ok() const { return !failed && !ferror(out); }
+
+private:
+    static const size_t NUMBER_ROOM = 352;          // longest %f of a double, plus sign
+
+    FILE* out;
+    vector<char> buffer;
+    size_t used = 0;
+    ios_base::fmtflags floatField = ios_base::fmtflags();
+    int precision = 6;
+    bool failed = false;
+
+    void reserve(size_t room) {
+        if (buffer.size() - used < room) flush();
+    }
+
+    template <typename T>
+    OutputWriter& writeNumber(T v) {
+        reserve(24);
+        auto r = to_chars(buffer.data() + used, buffer.data() + buffer.size(), v);
+        used = r.ptr - buffer.data();
+        return *this;
+    }
+
+    // Pending bytes first, then s, with no copy of s.
+    void writeDirect(string_view s) {
+#ifndef _WIN32
+        fflush(out);
+        iovec parts[2] = {{buffer.data(), used}, {const_cast<char*>(s.data()), s.size()}};
+        int fd = fileno(out);
+        size_t total = used + s.size();
+        while (total > 0) {
+            ssize_t n = writev(fd, parts, 2);
+            if (n < 0) {
+                failed = true;
+                break;
+            }
+            total -= n;
+            for (iovec& part : parts) {
+                size_t step = min((size_t)n, part.iov_len);
+                part.iov_base = (char*)part.iov_base + step;
+                part.iov_len -= step;
+                n -= step;
+            }
+        }
+        used = 0;
+#else
+        flush();
+        if (fwrite(s.data(), 1, s.size(), out) != s.size()) failed = true;
+#endif
+    }
+};
+
+#endif // OUTPUT_WRITER_HPP
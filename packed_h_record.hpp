@@ -0,0 +1,69 @@
+#ifndef PACKED_RECORD_HPP
+#define PACKED_RECORD_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <algorithm>
+#include "intern_h_pool.hpp"
+
+using namespace std;
+
+// ---------------- Packed Transaction Record ----------------
+// Fixed-width, trivially copyable form of Record for the hot sort path.
+// Strings become handles into globalStringPool(); the customer ID is kept
+// inline ("CUSTnnnn" fills the 8 bytes exactly, shorter IDs are NUL padded).
+
+struct PackedRecord {
+    char customerID[8];
+    double price;
+    int32_t date;           // YYYYMMDD, same encoding as Record::dateToInt()
+    int32_t product;
+    int32_t category;
+    int32_t paymentMethod;
+};
+
+static_assert(sizeof(PackedRecord) <= 32, "PackedRecord must fit in 32 bytes");
+static_assert(is_trivially_copyable<PackedRecord>::value, "PackedRecord must be memcpy-able");
+
+inline string customerIDOf(const PackedRecord& p) {
+    return string(p.customerID, strnlen(p.customerID, sizeof(p.customerID)));
+}
+
+// "DD/MM/YYYY" from YYYYMMDD
+inline string packedDateToString(int32_t date) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%02d/%02d/%04d", date % 100, (date / 100) % 100, date / 10000);
+    return string(buf);
+}
+
+// Works with the Record of either backend; both share the same field names.
+template <typename R>
+PackedRecord packRecord(const R& r) {
+    string_view customer = r.customerID;
+    PackedRecord p;
+    memset(p.customerID, 0, sizeof(p.customerID));
+    memcpy(p.customerID, customer.data(), min(customer.size(), sizeof(p.customerID)));
+    p.price = r.price;
+    p.date = r.dateToInt();
+    p.product = r.product.handle();
+    p.category = r.category.handle();
+    p.paymentMethod = r.paymentMethod.handle();
+    return p;
+}
+
+template <typename R>
+R unpackRecord(const PackedRecord& p) {
+    R r;
+    r.customerID = customerIDOf(p);
+    r.product = InternedString::fromHandle(p.product);
+    r.category = InternedString::fromHandle(p.category);
+    r.price = p.price;
+    r.date = packedDateToString(p.date);
+    r.paymentMethod = InternedString::fromHandle(p.paymentMethod);
+    return r;
+}
+
+#endif // PACKED_RECORD_HPP
@@ -0,0 +1,68 @@
+#ifndef PIPELINE_QUEUE_HPP
+#define PIPELINE_QUEUE_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+// ---------------- Bounded SPSC Queue ----------------
+// Ring buffer between exactly one producer and one consumer thread. Each
+// side owns one index and only reads the other's, so no locks are needed;
+// the release store of an index publishes the slot it covers. A full or
+// empty queue makes the caller yield rather than block, which keeps a
+// fast stage from running ahead of a slow one by more than `capacity`
+// items. Items are usually whole batches of rows.
+
+template <typename T>
+class SpscQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity = 64) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only.
+    void push(T item) {
+        size_t t = tail.load(memory_order_relaxed);
+        while (t - head.load(memory_order_acquire) > mask) this_thread::yield();
+        slots[t & mask] = move(item);
+        tail.store(t + 1, memory_order_release);
+    }
+
+    // Producer only: no more pushes; pop drains what is left, then fails.
+    void close() { closed.store(true, memory_order_release); }
+
+    // Consumer only. Waits for an item; false once closed and drained.
+    bool pop(T& item) {
+        size_t h = head.load(memory_order_relaxed);
+        while (true) {
+            if (h != tail.load(memory_order_acquire)) {
+                item = move(slots[h & mask]);
+                head.store(h + 1, memory_order_release);
+                return true;
+            }
+            // Re-check after seeing `closed`: the last push may have landed in between
+            if (closed.load(memory_order_acquire) && h == tail.load(memory_order_acquire)) return false;
+            this_thread::yield();
+        }
+    }
+
+private:
+    vector<T> slots;
+    size_t mask;
+    alignas(64) atomic<size_t> head{0};     // next slot to pop (consumer)
+    alignas(64) atomic<size_t> tail{0};     // next slot to fill (producer)
+    atomic<bool> closed{false};
+};
+
+#endif // PIPELINE_QUEUE_HPP
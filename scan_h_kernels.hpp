@@ -0,0 +1,237 @@
+#ifndef SCAN_KERNELS_HPP
+#define SCAN_KERNELS_HPP
+
+#include <cstdint>
+#include <vector>
+#include "packed_h_record.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// ---------------- Column Scan Kernels ----------------
+// Predicates over integer/double columns, evaluated 64 rows at a time into
+// one bitmap word (bit i = row i matches). With AVX2 each compare covers 8
+// int32 or 4 double lanes, with SSE2 half that; otherwise a branch-free
+// scalar loop is used. Build with -mavx2 (or -march=native) to enable AVX2.
+// Every kernel returns the match count and writes the bitmap if `out` is
+// non-null (one uint64_t per 64 rows, see bitmapWords).
+
+struct TransactionColumns {
+    vector<int32_t> date;       // YYYYMMDD
+    vector<int32_t> category;   // globalStringPool() handles
+    vector<int32_t> payment;
+    vector<double> price;
+
+    int size() const { return (int)date.size(); }
+
+    void append(const PackedRecord& p) {
+        date.push_back(p.date);
+        category.push_back(p.category);
+        payment.push_back(p.paymentMethod);
+        price.push_back(p.price);
+    }
+
+    // Works with the Record of either backend.
+    template <typename R>
+    void build(const R* records, int count) {
+        date.reserve(date.size() + count);
+        category.reserve(category.size() + count);
+        payment.reserve(payment.size() + count);
+        price.reserve(price.size() + count);
+        for (int i = 0; i < count; ++i) append(packRecord(records[i]));
+    }
+};
+
+inline size_t bitmapWords(int rows) { return (rows + 63) / 64; }
+
+namespace scan_detail {
+
+// Scalar mask for rows [begin, end) of one block (end - begin <= 64).
+template <typename Pred>
+inline uint64_t scalarMask(int begin, int end, Pred pred) {
+    uint64_t mask = 0;
+    for (int i = begin; i < end; ++i) mask |= (uint64_t)pred(i) << (i - begin);
+    return mask;
+}
+
+// Drives a block kernel over the column; tail rows use the scalar predicate.
+template <typename Block, typename Pred>
+inline int run(int n, uint64_t* out, Block block, Pred pred) {
+    int count = 0;
+    int full = n / 64;
+    for (int b = 0; b < full; ++b) {
+        uint64_t mask = block(b * 64);
+        if (out) out[b] = mask;
+        count += __builtin_popcountll(mask);
+    }
+    if (n % 64) {
+        uint64_t mask = scalarMask(full * 64, n, pred);
+        if (out) out[full] = mask;
+        count += __builtin_popcountll(mask);
+    }
+    return count;
+}
+
+#if defined(__AVX2__)
+inline uint64_t lanes8(__m256i m) { return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+inline uint64_t lanes4(__m256d m) { return (uint32_t)_mm256_movemask_pd(m); }
+#elif defined(__SSE2__)
+inline uint64_t lanes4(__m128i m) { return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(m)); }
+inline uint64_t lanes2(__m128d m) { return (uint32_t)_mm_movemask_pd(m); }
+#endif
+
+} // namespace scan_detail
+
+// date == d
+inline int scanDateEquals(const int32_t* date, int n, int32_t d, uint64_t* out = nullptr) {
+    auto pred = [=](int i) { return date[i] == d; };
+#if defined(__AVX2__)
+    __m256i target = _mm256_set1_epi32(d);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(date + base + k));
+            mask |= scan_detail::lanes8(_mm256_cmpeq_epi32(v, target)) << k;
+        }
+        return mask;
+    };
+#elif defined(__SSE2__)
+    __m128i target = _mm_set1_epi32(d);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(date + base + k));
+            mask |= scan_detail::lanes4(_mm_cmpeq_epi32(v, target)) << k;
+        }
+        return mask;
+    };
+#else
+    auto block = [=](int base) { return scan_detail::scalarMask(base, base + 64, pred); };
+#endif
+    return scan_detail::run(n, out, block, pred);
+}
+
+// lo <= date <= hi
+inline int scanDateInRange(const int32_t* date, int n, int32_t lo, int32_t hi, uint64_t* out = nullptr) {
+    auto pred = [=](int i) { return date[i] >= lo && date[i] <= hi; };
+    if (lo > hi) {
+        if (out) for (size_t w = 0; w < bitmapWords(n); ++w) out[w] = 0;
+        return 0;
+    }
+#if defined(__AVX2__)
+    // x >= lo && x <= hi  <=>  x > lo - 1 && hi + 1 > x  (dates never hit INT_MIN/MAX)
+    __m256i below = _mm256_set1_epi32(lo - 1);
+    __m256i above = _mm256_set1_epi32(hi + 1);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(date + base + k));
+            __m256i m = _mm256_and_si256(_mm256_cmpgt_epi32(v, below), _mm256_cmpgt_epi32(above, v));
+            mask |= scan_detail::lanes8(m) << k;
+        }
+        return mask;
+    };
+#elif defined(__SSE2__)
+    __m128i below = _mm_set1_epi32(lo - 1);
+    __m128i above = _mm_set1_epi32(hi + 1);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(date + base + k));
+            __m128i m = _mm_and_si128(_mm_cmpgt_epi32(v, below), _mm_cmpgt_epi32(above, v));
+            mask |= scan_detail::lanes4(m) << k;
+        }
+        return mask;
+    };
+#else
+    auto block = [=](int base) { return scan_detail::scalarMask(base, base + 64, pred); };
+#endif
+    return scan_detail::run(n, out, block, pred);
+}
+
+// category == c && payment == p
+inline int scanCategoryPayment(const int32_t* category, const int32_t* payment, int n,
+                               int32_t c, int32_t p, uint64_t* out = nullptr) {
+    auto pred = [=](int i) { return (category[i] == c) & (payment[i] == p); };
+#if defined(__AVX2__)
+    __m256i cv = _mm256_set1_epi32(c);
+    __m256i pv = _mm256_set1_epi32(p);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 8) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(category + base + k));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(payment + base + k));
+            __m256i m = _mm256_and_si256(_mm256_cmpeq_epi32(a, cv), _mm256_cmpeq_epi32(b, pv));
+            mask |= scan_detail::lanes8(m) << k;
+        }
+        return mask;
+    };
+#elif defined(__SSE2__)
+    __m128i cv = _mm_set1_epi32(c);
+    __m128i pv = _mm_set1_epi32(p);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 4) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(category + base + k));
+            __m128i b = _mm_loadu_si128((const __m128i*)(payment + base + k));
+            __m128i m = _mm_and_si128(_mm_cmpeq_epi32(a, cv), _mm_cmpeq_epi32(b, pv));
+            mask |= scan_detail::lanes4(m) << k;
+        }
+        return mask;
+    };
+#else
+    auto block = [=](int base) { return scan_detail::scalarMask(base, base + 64, pred); };
+#endif
+    return scan_detail::run(n, out, block, pred);
+}
+
+// price > x
+inline int scanPriceAbove(const double* price, int n, double x, uint64_t* out = nullptr) {
+    auto pred = [=](int i) { return price[i] > x; };
+#if defined(__AVX2__)
+    __m256d xv = _mm256_set1_pd(x);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 4) {
+            __m256d v = _mm256_loadu_pd(price + base + k);
+            mask |= scan_detail::lanes4(_mm256_cmp_pd(v, xv, _CMP_GT_OQ)) << k;
+        }
+        return mask;
+    };
+#elif defined(__SSE2__)
+    __m128d xv = _mm_set1_pd(x);
+    auto block = [=](int base) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 64; k += 2) {
+            __m128d v = _mm_loadu_pd(price + base + k);
+            mask |= scan_detail::lanes2(_mm_cmpgt_pd(v, xv)) << k;
+        }
+        return mask;
+    };
+#else
+    auto block = [=](int base) { return scan_detail::scalarMask(base, base + 64, pred); };
+#endif
+    return scan_detail::run(n, out, block, pred);
+}
+
+// Row index of the first set bit at or after `from`, or -1.
+inline int nextSelected(const uint64_t* bitmap, int rows, int from) {
+    if (from >= rows) return -1;
+    size_t w = from / 64;
+    uint64_t word = bitmap[w] & (~0ULL << (from % 64));
+    while (true) {
+        if (word) {
+            int row = (int)(w * 64 + __builtin_ctzll(word));
+            return row < rows ? row : -1;
+        }
+        if (++w >= bitmapWords(rows)) return -1;
+        word = bitmap[w];
+    }
+}
+
+#endif // SCAN_KERNELS_HPP
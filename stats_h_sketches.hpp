@@ -0,0 +1,424 @@
+#ifndef STATS_SKETCHES_HPP
+#define STATS_SKETCHES_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+// ---------------- Stable Hashing ----------------
+// FNV-1a with a splitmix64 finaliser. Unlike std::hash the value is the same
+// on every platform and build, which serialised sketches depend on.
+
+inline uint64_t stableHash64(string_view s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (char c : s) {
+        h ^= (unsigned char)c;
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// ---------------- Sketch Serialisation ----------------
+// Little-endian fixed-width fields, each sketch prefixed by a 4-byte tag.
+
+class SketchWriter {
+public:
+    explicit SketchWriter(string& out) : out(out) {}
+
+    template <typename T>
+    void put(T value) { out.append((const char*)&value, sizeof(T)); }
+
+    void putTag(const char* tag) { out.append(tag, 4); }
+
+    void putString(string_view s) {
+        put<uint32_t>((uint32_t)s.size());
+        out.append(s.data(), s.size());
+    }
+
+private:
+    string& out;
+};
+
+class SketchReader {
+public:
+    explicit SketchReader(string_view in) : in(in) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (pos + sizeof(T) > in.size()) return false;
+        memcpy(&value, in.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool expectTag(const char* tag) {
+        if (pos + 4 > in.size() || in.compare(pos, 4, string_view(tag, 4)) != 0) return false;
+        pos += 4;
+        return true;
+    }
+
+    bool getString(string& s) {
+        uint32_t size;
+        if (!get(size) || pos + size > in.size()) return false;
+        s.assign(in.data() + pos, size);
+        pos += size;
+        return true;
+    }
+
+private:
+    string_view in;
+    size_t pos = 0;
+};
+
+// ---------------- HyperLogLog ----------------
+// 2^precision one-byte registers; standard error is about 1.04 / sqrt(2^p)
+// (1.6% at p = 12, 4 KB). Merging two sketches is a register-wise max.
+
+class HyperLogLog {
+public:
+    explicit HyperLogLog(int precision = 12) : precision(precision), registers((size_t)1 << precision, 0) {}
+
+    void add(string_view item) { addHash(stableHash64(item)); }
+
+    void addHash(uint64_t h) {
+        size_t index = h >> (64 - precision);
+        uint64_t rest = (h << precision) | (1ULL << (precision - 1));    // guard bit bounds the rank
+        uint8_t rank = (uint8_t)(__builtin_clzll(rest) + 1);
+        if (rank > registers[index]) registers[index] = rank;
+    }
+
+    double estimate() const {
+        double m = (double)registers.size();
+        double sum = 0.0;
+        int zeros = 0;
+        for (uint8_t r : registers) {
+            sum += ldexp(1.0, -r);
+            if (r == 0) zeros++;
+        }
+        double alpha = 0.7213 / (1.0 + 1.079 / m);
+        double e = alpha * m * m / sum;
+        if (e <= 2.5 * m && zeros > 0) e = m * log(m / zeros);     // linear counting for small sets
+        return e;
+    }
+
+    // False (and unchanged) if the precisions differ.
+    bool merge(const HyperLogLog& other) {
+        if (other.precision != precision) return false;
+        for (size_t i = 0; i < registers.size(); ++i)
+            registers[i] = max(registers[i], other.registers[i]);
+        return true;
+    }
+
+    void serialize(SketchWriter& w) const {
+        w.putTag("HLL1");
+        w.put<uint8_t>((uint8_t)precision);
+        for (uint8_t r : registers) w.put(r);
+    }
+
+    bool deserialize(SketchReader& r) {
+        uint8_t p;
+        if (!r.expectTag("HLL1") || !r.get(p) || p < 4 || p > 18) return false;
+        precision = p;
+        registers.assign((size_t)1 << p, 0);
+        for (auto& reg : registers)
+            if (!r.get(reg)) return false;
+        return true;
+    }
+
+private:
+    int precision;
+    vector<uint8_t> registers;
+};
+
+// ---------------- KLL Quantile Sketch ----------------
+// A stack of compactors: level h holds items of weight 2^h. When a level
+// fills up it is sorted and every other item moves up a level, so total
+// weight is preserved and memory stays O(k). Until the first compaction
+// (n < k) quantiles are exact. The coin for which half moves up alternates
+// deterministically, so equal inputs always give equal sketches.
+
+class KLLSketch {
+public:
+    explicit KLLSketch(int k = 200) : k(k) {}
+
+    void add(double x) {
+        if (levels.empty()) levels.emplace_back();
+        levels[0].push_back(x);
+        n++;
+        compress();
+    }
+
+    // Nearest-rank quantile, q in [0, 1]; 0 for an empty sketch.
+    double quantile(double q) const {
+        if (n == 0) return 0.0;
+        vector<pair<double, uint64_t>> weighted;
+        for (size_t h = 0; h < levels.size(); ++h)
+            for (double v : levels[h]) weighted.push_back({v, 1ULL << h});
+        sort(weighted.begin(), weighted.end());
+
+        double target = max(1.0, ceil(q * (double)n));
+        uint64_t cumulative = 0;
+        for (const auto& item : weighted) {
+            cumulative += item.second;
+            if ((double)cumulative >= target) return item.first;
+        }
+        return weighted.back().first;
+    }
+
+    // False (and unchanged) if k differs.
+    bool merge(const KLLSketch& other) {
+        if (other.k != k) return false;
+        if (levels.size() < other.levels.size()) levels.resize(other.levels.size());
+        for (size_t h = 0; h < other.levels.size(); ++h)
+            levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+        n += other.n;
+        compress();
+        return true;
+    }
+
+    uint64_t count() const { return n; }
+
+    size_t retained() const {
+        size_t total = 0;
+        for (const auto& level : levels) total += level.size();
+        return total;
+    }
+
+    void serialize(SketchWriter& w) const {
+        w.putTag("KLL1");
+        w.put<uint32_t>((uint32_t)k);
+        w.put<uint64_t>(n);
+        w.put<uint64_t>(coin);
+        w.put<uint32_t>((uint32_t)levels.size());
+        for (const auto& level : levels) {
+            w.put<uint32_t>((uint32_t)level.size());
+            for (double v : level) w.put(v);
+        }
+    }
+
+    bool deserialize(SketchReader& r) {
+        uint32_t kk, levelCount;
+        if (!r.expectTag("KLL1") || !r.get(kk) || !r.get(n) || !r.get(coin) || !r.get(levelCount)) return false;
+        if (kk < 8 || levelCount > 64) return false;
+        k = (int)kk;
+        levels.assign(levelCount, vector<double>());
+        for (auto& level : levels) {
+            uint32_t size;
+            if (!r.get(size)) return false;
+            level.resize(size);
+            for (double& v : level)
+                if (!r.get(v)) return false;
+        }
+        return true;
+    }
+
+private:
+    int k;
+    uint64_t n = 0;
+    uint64_t coin = 0;
+    vector<vector<double>> levels;
+
+    // Top level holds k items, each level below 2/3 of the one above.
+    size_t capacity(size_t level) const {
+        double c = k * pow(2.0 / 3.0, (double)(levels.size() - 1 - level));
+        return max<size_t>(8, (size_t)ceil(c));
+    }
+
+    void compress() {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t h = 0; h < levels.size(); ++h) {
+                if (levels[h].size() < capacity(h)) continue;
+                if (h + 1 == levels.size()) levels.emplace_back();
+
+                vector<double>& level = levels[h];
+                vector<double>& above = levels[h + 1];
+                sort(level.begin(), level.end());
+                size_t pairs = level.size() / 2 * 2;      // an odd item stays behind
+                size_t offset = (coin++) & 1;
+                for (size_t i = offset; i < pairs; i += 2) above.push_back(level[i]);
+                level.erase(level.begin(), level.begin() + pairs);
+                changed = true;
+            }
+        }
+    }
+};
+
+// ---------------- Per-Category Transaction Sketches ----------------
+// Distinct customers per category (overall and per day) and price
+// quantiles per category. Keyed by category name rather than pool handle,
+// so sketches saved by different runs merge correctly.
+
+class TransactionStats {
+public:
+    static const int ANY = -1;
+
+    explicit TransactionStats(int precision = 12, int dailyPrecision = 10, int quantileK = 200)
+        : precision(precision), dailyPrecision(dailyPrecision), quantileK(quantileK) {}
+
+    // Empty sketches with the same parameters, e.g. one per loader thread.
+    TransactionStats emptyCopy() const { return TransactionStats(precision, dailyPrecision, quantileK); }
+
+    // Works with the Record of either backend.
+    template <typename R>
+    void add(const R& r) {
+        CategoryStats& c = statsFor(r.category);
+        uint64_t h = stableHash64(r.customerID);
+        c.customers.addHash(h);
+        int day = r.dateToInt();
+        auto it = c.daily.find(day);
+        if (it == c.daily.end()) it = c.daily.emplace(day, HyperLogLog(dailyPrecision)).first;
+        it->second.addHash(h);
+        c.prices.add(r.price);
+    }
+
+    // False if the two were built with different parameters.
+    bool merge(const TransactionStats& other) {
+        if (other.precision != precision || other.dailyPrecision != dailyPrecision || other.quantileK != quantileK)
+            return false;
+        for (const auto& entry : other.categories) {
+            CategoryStats& c = statsFor(entry.first);
+            c.customers.merge(entry.second.customers);
+            c.prices.merge(entry.second.prices);
+            for (const auto& day : entry.second.daily) {
+                auto it = c.daily.find(day.first);
+                if (it == c.daily.end()) c.daily.emplace(day.first, day.second);
+                else it->second.merge(day.second);
+            }
+        }
+        return true;
+    }
+
+    // day as YYYYMMDD, or ANY for all days
+    double distinctCustomers(const string& category, int day = ANY) const {
+        auto it = categories.find(category);
+        if (it == categories.end()) return 0.0;
+        if (day == ANY) return it->second.customers.estimate();
+        auto d = it->second.daily.find(day);
+        return d == it->second.daily.end() ? 0.0 : d->second.estimate();
+    }
+
+    // Inclusive YYYYMMDD range, e.g. a month, from the daily sketches.
+    double distinctCustomersInRange(const string& category, int fromDay, int toDay) const {
+        auto it = categories.find(category);
+        if (it == categories.end()) return 0.0;
+        HyperLogLog combined(dailyPrecision);
+        for (auto d = it->second.daily.lower_bound(fromDay); d != it->second.daily.end() && d->first <= toDay; ++d)
+            combined.merge(d->second);
+        return combined.estimate();
+    }
+
+    double priceQuantile(const string& category, double q) const {
+        auto it = categories.find(category);
+        return it == categories.end() ? 0.0 : it->second.prices.quantile(q);
+    }
+
+    uint64_t transactionCount(const string& category) const {
+        auto it = categories.find(category);
+        return it == categories.end() ? 0 : it->second.prices.count();
+    }
+
+    vector<string> categoryNames() const {
+        vector<string> names;
+        for (const auto& entry : categories) names.push_back(entry.first);
+        return names;
+    }
+
+    string serialize() const {
+        string out;
+        SketchWriter w(out);
+        w.putTag("TXS1");
+        w.put<uint8_t>((uint8_t)precision);
+        w.put<uint8_t>((uint8_t)dailyPrecision);
+        w.put<uint32_t>((uint32_t)quantileK);
+        w.put<uint32_t>((uint32_t)categories.size());
+        for (const auto& entry : categories) {
+            w.putString(entry.first);
+            entry.second.customers.serialize(w);
+            entry.second.prices.serialize(w);
+            w.put<uint32_t>((uint32_t)entry.second.daily.size());
+            for (const auto& day : entry.second.daily) {
+                w.put<int32_t>(day.first);
+                day.second.serialize(w);
+            }
+        }
+        return out;
+    }
+
+    bool deserialize(string_view data) {
+        SketchReader r(data);
+        uint8_t p, dp;
+        uint32_t k, count;
+        if (!r.expectTag("TXS1") || !r.get(p) || !r.get(dp) || !r.get(k) || !r.get(count)) return false;
+        TransactionStats loaded(p, dp, (int)k);
+        for (uint32_t i = 0; i < count; ++i) {
+            string name;
+            uint32_t days;
+            if (!r.getString(name)) return false;
+            CategoryStats& c = loaded.statsFor(name);
+            if (!c.customers.deserialize(r) || !c.prices.deserialize(r) || !r.get(days)) return false;
+            for (uint32_t d = 0; d < days; ++d) {
+                int32_t day;
+                HyperLogLog sketch(dp);
+                if (!r.get(day) || !sketch.deserialize(r)) return false;
+                c.daily.emplace(day, move(sketch));
+            }
+        }
+        *this = move(loaded);
+        return true;
+    }
+
+private:
+    struct CategoryStats {
+        HyperLogLog customers;
+        KLLSketch prices;
+        map<int, HyperLogLog> daily;    // YYYYMMDD -> distinct customers that day
+
+        CategoryStats(int precision, int k) : customers(precision), prices(k) {}
+    };
+
+    int precision;
+    int dailyPrecision;
+    int quantileK;
+    map<string, CategoryStats, less<>> categories;   // less<>: found by string_view
+
+    CategoryStats& statsFor(string_view category) {
+        auto it = categories.find(category);
+        if (it == categories.end())
+            it = categories.emplace(string(category), CategoryStats(precision, quantileK)).first;
+        return it->second;
+    }
+};
+
+inline bool saveTransactionStats(const TransactionStats& stats, const string& filename) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    string data = stats.serialize();
+    file.write(data.data(), data.size());
+    return (bool)file;
+}
+
+inline bool loadTransactionStats(const string& filename, TransactionStats& stats) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+    stringstream buffer;
+    buffer << file.rdbuf();
+    return stats.deserialize(buffer.str());
+}
+
+#endif // STATS_SKETCHES_HPP
@@ -0,0 +1,129 @@
+#ifndef STRING_SORT_HPP
+#define STRING_SORT_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// ---------------- Multikey Quicksort on Strings ----------------
+// Sorts row indices by a string column without moving the rows. Each pass
+// compares 8 bytes of the strings at once: the bytes at the current depth
+// are packed big-endian into a uint64_t cached next to the index, so the
+// partitioning loop never touches the heap strings. Rows whose cached
+// chunk ties with the pivot move on to the next 8 bytes together.
+// Equal strings keep input order, or the reverse of it with reverseTies
+// (the order mergeSortR leaves them in, as it takes the right side on ties).
+
+namespace string_sort_detail {
+
+struct Item {
+    uint64_t key;       // bytes [depth, depth + 8) of the string, zero padded
+    int32_t index;
+};
+
+inline uint64_t chunkAt(string_view s, size_t depth) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        unsigned char c = depth + i < s.size() ? (unsigned char)s[depth + i] : 0;
+        key = (key << 8) | c;
+    }
+    return key;
+}
+
+class Sorter {
+public:
+    Sorter(const vector<string_view>& views, bool reverseTies) : views(views), reverseTies(reverseTies) {}
+
+    void sort(Item* a, int n, size_t depth) {
+        while (n > 1) {
+            if (n < 16) {
+                insertionSort(a, n, depth);
+                return;
+            }
+
+            uint64_t pivot = medianOfThree(a[0].key, a[n / 2].key, a[n - 1].key);
+
+            // Three-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+            int lt = 0, i = 0, gt = n;
+            while (i < gt) {
+                if (a[i].key < pivot) swap(a[lt++], a[i++]);
+                else if (a[i].key > pivot) swap(a[i], a[--gt]);
+                else i++;
+            }
+            sort(a, lt, depth);
+            sort(a + gt, n - gt, depth);
+
+            // Equal chunk: strings that end inside it are finished and
+            // come first (shorter first); the rest continue 8 bytes deeper
+            Item* equal = a + lt;
+            int count = gt - lt;
+            int done = (int)(std::partition(equal, equal + count,
+                                            [&](const Item& x) { return views[x.index].size() <= depth + 8; }) - equal);
+            std::sort(equal, equal + done, [&](const Item& x, const Item& y) {
+                size_t lx = views[x.index].size(), ly = views[y.index].size();
+                return lx != ly ? lx < ly : tieBefore(x.index, y.index);
+            });
+
+            a = equal + done;
+            n = count - done;
+            depth += 8;
+            for (int k = 0; k < n; ++k) a[k].key = chunkAt(views[a[k].index], depth);
+        }
+    }
+
+private:
+    const vector<string_view>& views;
+    bool reverseTies;
+
+    bool tieBefore(int32_t x, int32_t y) const { return reverseTies ? x > y : x < y; }
+
+    bool less(const Item& x, const Item& y, size_t depth) const {
+        if (x.key != y.key) return x.key < y.key;
+        int c = views[x.index].substr(min(depth, views[x.index].size()))
+                    .compare(views[y.index].substr(min(depth, views[y.index].size())));
+        return c != 0 ? c < 0 : tieBefore(x.index, y.index);
+    }
+
+    void insertionSort(Item* a, int n, size_t depth) {
+        for (int i = 1; i < n; ++i) {
+            Item x = a[i];
+            int j = i - 1;
+            while (j >= 0 && less(x, a[j], depth)) {
+                a[j + 1] = a[j];
+                --j;
+            }
+            a[j + 1] = x;
+        }
+    }
+
+    static uint64_t medianOfThree(uint64_t a, uint64_t b, uint64_t c) {
+        if (a < b) return b < c ? b : (a < c ? c : a);
+        return a < c ? a : (b < c ? c : b);
+    }
+};
+
+} // namespace string_sort_detail
+
+// Permutation of [0, n) ordering keyOf(i) (anything convertible to
+// string_view) ascending; the strings must outlive the call.
+template <typename KeyFn>
+vector<int32_t> stringSortOrder(int n, KeyFn keyOf, bool reverseTies = false) {
+    using namespace string_sort_detail;
+    vector<string_view> views(n);
+    vector<Item> items(n);
+    for (int i = 0; i < n; ++i) {
+        views[i] = keyOf(i);
+        items[i] = Item{chunkAt(views[i], 0), i};
+    }
+
+    Sorter(views, reverseTies).sort(items.data(), n, 0);
+
+    vector<int32_t> order(n);
+    for (int i = 0; i < n; ++i) order[i] = items[i].index;
+    return order;
+}
+
+#endif // STRING_SORT_HPP
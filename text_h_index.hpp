@@ -0,0 +1,191 @@
+#ifndef TEXT_INDEX_HPP
+#define TEXT_INDEX_HPP
+
+#include <cstdint>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "intern_h_pool.hpp"
+
+using namespace std;
+
+// ---------------- Review Tokenizer ----------------
+// Same terms as splitting on whitespace and applying cleanWord(): letters
+// and digits only, lower-cased; tokens that clean to nothing are skipped.
+
+template <typename Fn>
+void forEachTerm(string_view text, Fn fn) {
+    string term;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && isspace((unsigned char)text[i])) ++i;
+        term.clear();
+        while (i < text.size() && !isspace((unsigned char)text[i])) {
+            unsigned char c = text[i++];
+            if (isalnum(c)) term += (char)tolower(c);
+        }
+        if (!term.empty()) fn(term);
+    }
+}
+
+// ---------------- Postings List ----------------
+// Ascending review IDs stored as varint-encoded gaps (1 byte per ID for
+// any term that appears in at least one of every 128 reviews).
+
+class PostingsList {
+public:
+    // IDs must arrive in non-decreasing order; repeats are ignored.
+    void append(uint32_t id) {
+        if (count > 0 && id == last) return;
+        uint32_t gap = count > 0 ? id - last : id;
+        while (gap >= 0x80) {
+            bytes.push_back((uint8_t)(gap | 0x80));
+            gap >>= 7;
+        }
+        bytes.push_back((uint8_t)gap);
+        last = id;
+        count++;
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        uint32_t id = 0;
+        size_t i = 0;
+        while (i < bytes.size()) {
+            uint32_t gap = 0;
+            int shift = 0;
+            while (bytes[i] & 0x80) {
+                gap |= (uint32_t)(bytes[i++] & 0x7F) << shift;
+                shift += 7;
+            }
+            gap |= (uint32_t)bytes[i++] << shift;
+            id += gap;
+            fn(id);
+        }
+    }
+
+    vector<uint32_t> decode() const {
+        vector<uint32_t> ids;
+        ids.reserve(count);
+        forEach([&](uint32_t id) { ids.push_back(id); });
+        return ids;
+    }
+
+    int size() const { return count; }
+    size_t byteSize() const { return bytes.size(); }
+
+private:
+    vector<uint8_t> bytes;
+    uint32_t last = 0;
+    int count = 0;
+};
+
+// ---------------- Review Text Index ----------------
+// term -> postings of review IDs, plus per-review rating and product so
+// queries can be filtered without touching the reviews. Review IDs are
+// positions (array index or list position) and must be added in order,
+// so new reviews are indexed by appending them.
+
+struct ReviewQuery {
+    vector<string> terms;       // raw words, tokenized like the reviews
+    bool matchAll = true;       // AND when true, OR otherwise
+    int minRating = 1;
+    int maxRating = 5;
+    string product;             // empty matches every product
+};
+
+class ReviewTextIndex {
+public:
+    // Returns the new review's ID.
+    uint32_t addReview(string_view text, int rating, string_view product) {
+        uint32_t id = (uint32_t)ratings.size();
+        ratings.push_back((int8_t)rating);
+        products.push_back(globalStringPool().intern(product));
+        forEachTerm(text, [&](const string& term) { postings[term].append(id); });
+        return id;
+    }
+
+    // Matching review IDs, ascending.
+    vector<uint32_t> search(const ReviewQuery& query) const {
+        vector<const PostingsList*> lists;
+        for (const string& word : query.terms) {
+            forEachTerm(word, [&](const string& term) {
+                auto it = postings.find(term);
+                lists.push_back(it == postings.end() ? nullptr : &it->second);
+            });
+        }
+
+        vector<uint32_t> ids = query.matchAll ? intersect(lists) : unite(lists);
+
+        int product = -1;
+        if (!query.product.empty()) {
+            product = globalStringPool().find(query.product);
+            if (product < 0) return {};
+        }
+        vector<uint32_t> out;
+        for (uint32_t id : ids) {
+            if (ratings[id] < query.minRating || ratings[id] > query.maxRating) continue;
+            if (product >= 0 && products[id] != product) continue;
+            out.push_back(id);
+        }
+        return out;
+    }
+
+    int documentFrequency(string_view term) const {
+        auto it = postings.find(string(term));
+        return it == postings.end() ? 0 : it->second.size();
+    }
+
+    int reviewCount() const { return (int)ratings.size(); }
+    size_t termCount() const { return postings.size(); }
+
+    size_t postingsBytes() const {
+        size_t total = 0;
+        for (const auto& entry : postings) total += entry.second.byteSize();
+        return total;
+    }
+
+private:
+    unordered_map<string, PostingsList> postings;
+    vector<int8_t> ratings;
+    vector<int32_t> products;       // globalStringPool() handles
+
+    // Shortest list first; the rest are streamed against the candidates.
+    static vector<uint32_t> intersect(vector<const PostingsList*> lists) {
+        if (lists.empty()) return {};
+        for (const PostingsList* list : lists)
+            if (!list) return {};
+        sort(lists.begin(), lists.end(),
+             [](const PostingsList* a, const PostingsList* b) { return a->size() < b->size(); });
+
+        vector<uint32_t> candidates = lists[0]->decode();
+        for (size_t k = 1; k < lists.size() && !candidates.empty(); ++k) {
+            vector<uint32_t> kept;
+            size_t i = 0;
+            lists[k]->forEach([&](uint32_t id) {
+                while (i < candidates.size() && candidates[i] < id) ++i;
+                if (i < candidates.size() && candidates[i] == id) kept.push_back(id);
+            });
+            candidates.swap(kept);
+        }
+        return candidates;
+    }
+
+    static vector<uint32_t> unite(const vector<const PostingsList*>& lists) {
+        vector<uint32_t> result;
+        for (const PostingsList* list : lists) {
+            if (!list) continue;
+            vector<uint32_t> ids = list->decode();
+            vector<uint32_t> merged;
+            merged.reserve(result.size() + ids.size());
+            set_union(result.begin(), result.end(), ids.begin(), ids.end(), back_inserter(merged));
+            result.swap(merged);
+        }
+        return result;
+    }
+};
+
+#endif // TEXT_INDEX_HPP
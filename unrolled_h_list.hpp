@@ -0,0 +1,299 @@
+#ifndef UNROLLED_LIST_HPP
+#define UNROLLED_LIST_HPP
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <iterator>
+
+using namespace std;
+
+// ---------------- Unrolled Linked List ----------------
+// A singly linked list of blocks holding up to BLOCK items each, so a walk
+// touches one node header per BLOCK records instead of one per record and
+// the records of a block sit next to each other in memory.
+// Appends fill the tail block; insert splits a full block in half; erase
+// and removeIf close gaps in place and free blocks that become empty.
+// Reordering (sorts) is done through a permutation computed on keys, then
+// applied by moving items once.
+
+template <typename T, int BLOCK = 64>
+class UnrolledList {
+    struct Block {
+        int count = 0;
+        Block* next = nullptr;
+        T items[BLOCK];
+    };
+
+public:
+    template <typename Item, typename BlockPtr>
+    class Iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = Item*;
+        using reference = Item&;
+
+        Iterator(BlockPtr block = nullptr, int index = 0) : block(block), index(index) {}
+        Item& operator*() const { return block->items[index]; }
+        Item* operator->() const { return &block->items[index]; }
+        Iterator& operator++() {
+            if (++index == block->count) {
+                block = block->next;
+                index = 0;
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iterator& other) const { return block == other.block && index == other.index; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        BlockPtr block;
+        int index;
+    };
+
+    using iterator = Iterator<T, Block*>;
+    using const_iterator = Iterator<const T, const Block*>;
+
+    UnrolledList() = default;
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+    UnrolledList(UnrolledList&& other) noexcept { swap(other); }
+    UnrolledList& operator=(UnrolledList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+    ~UnrolledList() { clear(); }
+
+    iterator begin() { return iterator(head); }
+    iterator end() { return iterator(); }
+    const_iterator begin() const { return const_iterator(head); }
+    const_iterator end() const { return const_iterator(); }
+
+    int size() const { return total; }
+    bool empty() const { return total == 0; }
+    int blockCount() const { return blocks; }
+
+    void clear() {
+        while (head) {
+            Block* next = head->next;
+            delete head;
+            head = next;
+        }
+        tail = nullptr;
+        total = 0;
+        blocks = 0;
+    }
+
+    void push_back(T value) {
+        if (!tail || tail->count == BLOCK) linkAfter(tail, new Block);
+        tail->items[tail->count++] = move(value);
+        ++total;
+    }
+
+    // O(size / BLOCK) walk over the block headers.
+    T& at(int pos) {
+        Block* b = locate(pos);
+        return b->items[pos];
+    }
+    const T& at(int pos) const { return const_cast<UnrolledList*>(this)->at(pos); }
+
+    // Inserts before position pos (0 <= pos <= size()).
+    void insert(int pos, T value) {
+        if (pos >= total) {
+            push_back(move(value));
+            return;
+        }
+        Block* b = locate(pos);
+        if (b->count == BLOCK) {
+            // Split: the upper half moves to a new block after b
+            Block* upper = new Block;
+            int half = BLOCK / 2;
+            for (int i = half; i < BLOCK; ++i) upper->items[i - half] = move(b->items[i]);
+            upper->count = BLOCK - half;
+            b->count = half;
+            linkAfter(b, upper);
+            if (pos > half) {
+                b = upper;
+                pos -= half;
+            }
+        }
+        for (int i = b->count; i > pos; --i) b->items[i] = move(b->items[i - 1]);
+        b->items[pos] = move(value);
+        b->count++;
+        ++total;
+    }
+
+    // Removes position pos; a block drained below a quarter is merged with
+    // its successor when both fit in one block.
+    void erase(int pos) {
+        Block* previous = nullptr;
+        Block* b = head;
+        while (pos >= b->count) {
+            pos -= b->count;
+            previous = b;
+            b = b->next;
+        }
+        for (int i = pos; i + 1 < b->count; ++i) b->items[i] = move(b->items[i + 1]);
+        b->count--;
+        --total;
+        if (b->count == 0) {
+            unlink(previous, b);
+        } else if (b->count < BLOCK / 4 && b->next && b->count + b->next->count <= BLOCK) {
+            Block* next = b->next;
+            for (int i = 0; i < next->count; ++i) b->items[b->count++] = move(next->items[i]);
+            unlink(b, next);
+        }
+    }
+
+    // Drops every item matching pred in one pass, keeping the order of the
+    // rest. Survivors are packed forward, so afterwards only the last block
+    // can be partly empty. Packing moves items even when nothing matches
+    // (after insert/erase left gaps), so the counts are always rewritten.
+    template <typename Pred>
+    int removeIf(Pred pred) {
+        Block* write = head;
+        int w = 0;
+        int removed = 0;
+        for (Block* b = head; b; b = b->next) {
+            for (int i = 0; i < b->count; ++i) {
+                if (pred(b->items[i])) {
+                    ++removed;
+                    continue;
+                }
+                if (w == BLOCK) {
+                    write->count = BLOCK;
+                    write = write->next;
+                    w = 0;
+                }
+                if (write != b || w != i) write->items[w] = move(b->items[i]);
+                ++w;
+            }
+        }
+        // write is the last block still holding items; free everything after it
+        total -= removed;
+        if (total == 0) {
+            clear();
+            return removed;
+        }
+        write->count = w;
+        Block* extra = write->next;
+        write->next = nullptr;
+        tail = write;
+        while (extra) {
+            Block* next = extra->next;
+            delete extra;
+            --blocks;
+            extra = next;
+        }
+        return removed;
+    }
+
+    // Reorders so that new position i holds the item previously at order[i]
+    // (a permutation of [0, size())). Blocks come out full.
+    void permute(const vector<int32_t>& order) {
+        vector<T*> items;
+        items.reserve(total);
+        for (Block* b = head; b; b = b->next)
+            for (int i = 0; i < b->count; ++i) items.push_back(&b->items[i]);
+
+        vector<T> moved;
+        moved.reserve(total);
+        for (int32_t index : order) moved.push_back(move(*items[index]));
+
+        UnrolledList result;
+        for (T& item : moved) result.push_back(move(item));
+        *this = move(result);
+    }
+
+    // First position whose item does not satisfy before(item); the list
+    // must be partitioned by before (e.g. sorted, before = "key < target").
+    // Binary search over the blocks' last items, then inside one block.
+    template <typename Before>
+    int partitionPoint(Before before) const {
+        vector<const Block*> index;
+        index.reserve(blocks);
+        for (const Block* b = head; b; b = b->next) index.push_back(b);
+
+        int lo = 0, hi = (int)index.size();
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            const Block* b = index[mid];
+            if (before(b->items[b->count - 1])) lo = mid + 1;
+            else hi = mid;
+        }
+
+        int position = 0;
+        for (int i = 0; i < lo; ++i) position += index[i]->count;
+        if (lo == (int)index.size()) return position;
+
+        const Block* b = index[lo];
+        int first = 0, last = b->count;
+        while (first < last) {
+            int mid = (first + last) / 2;
+            if (before(b->items[mid])) first = mid + 1;
+            else last = mid;
+        }
+        return position + first;
+    }
+
+    const_iterator iteratorAt(int pos) const {
+        if (pos >= total) return end();
+        const Block* b = const_cast<UnrolledList*>(this)->locate(pos);
+        return const_iterator(b, pos);
+    }
+
+private:
+    Block* head = nullptr;
+    Block* tail = nullptr;
+    int total = 0;
+    int blocks = 0;
+
+    void swap(UnrolledList& other) {
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(total, other.total);
+        std::swap(blocks, other.blocks);
+    }
+
+    // Block holding pos; pos becomes the index inside it.
+    Block* locate(int& pos) {
+        Block* b = head;
+        while (pos >= b->count) {
+            pos -= b->count;
+            b = b->next;
+        }
+        return b;
+    }
+
+    void linkAfter(Block* previous, Block* b) {
+        if (!previous) {
+            b->next = head;
+            head = b;
+        } else {
+            b->next = previous->next;
+            previous->next = b;
+        }
+        if (tail == previous) tail = b;
+        ++blocks;
+    }
+
+    void unlink(Block* previous, Block* b) {
+        if (previous) previous->next = b->next;
+        else head = b->next;
+        if (tail == b) tail = previous;
+        delete b;
+        --blocks;
+    }
+};
+
+#endif // UNROLLED_LIST_HPP